@@ -0,0 +1,79 @@
+// Measures how the TMX parsing time grows
+// with the map size. Build from the root:
+// g++ -O2 -std=c++11 dev/tmxbench.cpp src/Core/Tilemap.cpp
+//   src/Core/Trace.cpp src/Core/Utility.cpp -lpthread -o tmxbench
+
+#include "../src/Core/Tilemap.hpp"
+#include "../src/Core/Utility.hpp"
+
+#include <cstdio>
+#include <string>
+
+// Make a map of the given size with two layers
+static std::string makeMap(int size) {
+
+    std::string out = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<map version=\"1.2\" width=\"" + intToString(size) +
+        "\" height=\"" + intToString(size) + "\" tilewidth=\"16\" "
+        "tileheight=\"16\">\n <properties>\n"
+        "  <property name=\"name\" value=\"Benchmark\"/>\n"
+        "  <property name=\"moves\" value=\"10\"/>\n"
+        " </properties>\n";
+
+    for(int l = 0; l < 2; ++ l) {
+
+        out += " <layer id=\"" + intToString(l+1) + "\" width=\"" +
+            intToString(size) + "\" height=\"" + intToString(size) +
+            "\">\n  <data encoding=\"csv\">\n";
+        for(int y = 0; y < size; ++ y) {
+
+            for(int x = 0; x < size; ++ x) {
+
+                out += intToString((x*7 + y*13) % 100);
+                if(x < size-1 || y < size-1) out += ",";
+            }
+            out += "\n";
+        }
+        out += "</data>\n </layer>\n";
+    }
+    out += "</map>\n";
+
+    return out;
+}
+
+
+// Main
+int main(int argc, char** argv) {
+
+    const int ROUNDS = 5;
+    const int SIZES[] = {125, 250, 500, 1000};
+
+    printf("%8s %12s %12s %10s\n", "size", "bytes", "ms", "ns/tile");
+    for(int i = 0; i < 4; ++ i) {
+
+        std::string text = makeMap(SIZES[i]);
+
+        // Best of a few rounds
+        int64 best = -1;
+        int64 start, t;
+        for(int r = 0; r < ROUNDS; ++ r) {
+
+            start = getNanoTime();
+            Tilemap map(text.c_str(), (int)text.length());
+            t = getNanoTime() - start;
+
+            if(best < 0 || t < best) best = t;
+            if(map.getTile(1, SIZES[i]-1, SIZES[i]-1) < 0) {
+
+                printf("Parsing failed\n");
+                return 1;
+            }
+        }
+
+        printf("%8d %12d %12.2f %10.2f\n", SIZES[i], (int)text.length(),
+            best / 1000000.0,
+            (double)best / (2.0 * SIZES[i] * SIZES[i]));
+    }
+
+    return 0;
+}
@@ -3,8 +3,20 @@
 
 #include "Application.hpp"
 
+#include "Utility.hpp"
+#include "Trace.hpp"
+#include "Packer.hpp"
+#include "TextureBudget.hpp"
+
 #include <stdexcept>
 #include <cstdio>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include <sys/stat.h>
 
 #include <GL/gl.h>
 
@@ -21,9 +33,18 @@ static void resizeFramebuffer(GLFWwindow* window,
 }
 
 
+// Window content lost
+static void refreshWindow(GLFWwindow* window) {
+
+    self->invalidate();
+}
+
+
 // Initialize GLFW & GL content
 void Application::initGL() {
 
+    TraceScope trace("Application::initGL");
+
     // Initialize GLFW
     if(glfwInit() == 0) {
 
@@ -38,33 +59,54 @@ void Application::initGL() {
     //glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
     //glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
 
+    // A headless window is never shown, everything
+    // is drawn to an offscreen framebuffer instead
+    if(headless) {
+
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     // Create window
     window = glfwCreateWindow(width, height, caption.c_str(), NULL, NULL);
     winSize[0] = width;
     winSize[1] = height;
+    if(window == NULL) {
+
+        throw std::runtime_error("Failed to create a window!");
+    }
     // Set OpenGL context to this window
     glfwMakeContextCurrent(window);
 
     // Toggle fullscreen, if wanted
-    bool fs = conf.getIntParam("fullscreen", 0) == 1;
+    bool fs = !headless && conf.getIntParam("fullscreen", 0) == 1;
     fullscreen = false;
     if(fs) {
 
-        toggleFullscreen();
+        setFullscreen();
     }
     else {
 
         fullscreen = false;
     }
 
-    // Enable VSync
-    glfwSwapInterval(1);
+    // Enable VSync, unless running uncapped
+    glfwSwapInterval(headless ? 0 : 1);
 
     // Initialize GLEW
     if(glewInit() != GLEW_OK) {
 
         throw std::runtime_error("Failed to initialize GLEW!");
     }
+    // Nothing is known about the new context
+    GLState::invalidate();
+
+    // Create offscreen target
+    target = NULL;
+    if(headless) {
+
+        target = new Framebuffer(width, height);
+        target->bind();
+    }
 
     // Hide cursor
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
@@ -72,14 +114,54 @@ void Application::initGL() {
     // Register core events
     self = this;
     glfwSetFramebufferSizeCallback(window, resizeFramebuffer);
+    glfwSetWindowRefreshCallback(window, refreshWindow);
 }
 
 
 // Initialize
 void Application::init() {
+
+    // Tracing, from the start if wanted
+    Trace::setThreadName("Main");
+    Trace::setPath(conf.getParam("trace_path", "trace.json"));
+    if(conf.getIntParam("trace", 0) == 1) {
+
+        Trace::start();
+    }
+    TraceScope trace("Application::init");
+
+    // Threading
+    threaded = conf.getIntParam("threaded", 0) == 1;
+    fullscreenRequest = false;
+
+    // Timing
+    maxUpdates = conf.getIntParam("max_updates", 5);
+    if(maxUpdates < 1) maxUpdates = 1;
+    carryBacklog = conf.getParam("catch_up", "drop") == "carry";
+    interpolate = conf.getIntParam("interpolate", 1) == 1;
+    lowPower = conf.getIntParam("low_power", 1) == 1;
+    idleWait = conf.getIntParam("idle_wait", 100) / 1000.0;
+    idleSteps = 0;
+    redraw = true;
+
+    // Headless options
+    headless = conf.getIntParam("headless", 0) == 1;
+    frameLimit = conf.getIntParam("headless_frames", 0);
+    dumpPath = conf.getParam("dump_path", "");
+    dumpRaw = conf.getParam("dump_format", "png") == "raw";
+
+    std::istringstream frames(conf.getParam("dump_frames"));
+    std::string frame;
+    while(std::getline(frames, frame, ',')) {
+
+        dumpFrames.push_back(strToInt(frame));
+    }
     
     // Initialize OpenGL content
     initGL();
+    // Texture memory budget, in megabytes
+    TextureBudget::setBudget((int64)conf.getIntParam("texture_budget", 0)
+        * 1024 * 1024);
 
     // Create graphics
     graph = new Graphics();
@@ -94,8 +176,21 @@ void Application::init() {
         printf("Warning: error reading controls config:%s\n",
             err.what());
     }
+    // Create audio driver
+    AudioDriver* audioDriver;
+    try {
+
+        audioDriver = AudioDriver::create(conf.getParam("audio_driver", "sdl"),
+            conf.getParam("audio_capture_path", "capture.wav"),
+            conf.getParam("audio_capture_mode", "offline") == "realtime");
+    }
+    catch(std::runtime_error err) {
+
+        printf("Warning: %s. Audio disabled.\n", err.what());
+        audioDriver = new NullAudioDriver();
+    }
     // Create event manager
-    evMan = new EventManager(this, (void*)window, &vpad);
+    evMan = new EventManager(this, (void*)window, &vpad, audioDriver);
     // Set joystick state
     evMan->hardToggleJoystick(conf.getIntParam("enable_joystick", 0) == 1);
     // Initialize virtual gamepad input
@@ -104,12 +199,56 @@ void Application::init() {
     // Set audio states
     AudioManager* audio = evMan->getAudioManager();
     audio->toggleSfx(conf.getIntParam("sfx_enabled", 1) == 1);
-    audio->toggleSfx(conf.getIntParam("music_enabled", 1) == 1);
+    audio->toggleMusic(conf.getIntParam("music_enabled", 1) == 1);
     audio->setSfxVolume(conf.getFloatParam("sfx_volume", 1.0f));
     audio->setMusicVolume(conf.getFloatParam("music_volume", 1.0f));
 
-    // Load assets
-    assets = new AssetPack(conf.getParam("asset_path"));
+    // Debug output
+    glStats = conf.getIntParam("gl_stats", 0) == 1;
+    frameCount = 0;
+    profile = conf.getIntParam("profiler", 0) == 1;
+    if(profile) {
+
+        Profiler::enable();
+    }
+    // Frame statistics
+    stats = NULL;
+    statsRequest = false;
+    statsPath = conf.getParam("frame_stats", "");
+    if(statsPath.length() > 0) {
+
+        stats = new FrameStats((int64)(NS_PER_SECOND / 
+            conf.getIntParam("framerate", 60)));
+    }
+
+    // Load assets, from the archive if there
+    // is one, the loose files otherwise. Hot
+    // reloading needs the loose files. Only a
+    // broken archive is worth a warning
+    assets = NULL;
+    std::string archivePath = conf.getParam("archive_path", "");
+    struct stat archiveStat;
+    if(archivePath.length() > 0 && conf.getIntParam("hot_reload", 0) != 1 &&
+       stat(archivePath.c_str(), &archiveStat) == 0) {
+
+        Archive* archive = NULL;
+        try {
+
+            archive = new Archive(archivePath);
+            assets = new AssetPack(archive);
+        }
+        catch(std::runtime_error err) {
+
+            printf("Warning: %s. Loading the loose files.\n", err.what());
+            delete archive;
+        }
+    }
+    if(assets == NULL) {
+
+        assets = new AssetPack(conf.getParam("asset_path"));
+    }
+    // Filled shapes can use the atlas, too
+    graph->setWhiteBitmap(assets->getWhiteBitmap());
 
     // Create scene manager
     sceneMan = new SceneManager(evMan, assets);
@@ -123,6 +262,15 @@ void Application::init() {
 
     // Initialize scenes
     sceneMan->init();
+    // Start from another scene, if wanted
+    std::string start = conf.getParam("start_scene");
+    if(start.length() > 0) {
+
+        sceneMan->changeActiveScene(start);
+    }
+
+    // Watch the files
+    initHotReload();
 
     // Set running
     running = true;
@@ -132,49 +280,107 @@ void Application::init() {
 // Event loop
 void Application::loop() {
     
-    const int MAX_UPDATE_COUNT = 5;
-    const float COMPARED_FPS = 60.0f;
-
-    float timeSum = 0.0f;
-    float oldTime = 0.0f;
-    glfwSetTime(0.0);
-
-    // Compute desired frame wait
+    // Compute desired frame wait. The logic runs at
+    // a fixed rate, independent of the refresh rate
     float framerate = conf.getIntParam("framerate", 60);
     float tm = COMPARED_FPS / framerate;
-    float frameWait = 1.0f / framerate;
+    int64 frameWait = (int64)(NS_PER_SECOND / framerate);
+
+    // Times in nanoseconds
+    int64 timeSum = 0;
+    int64 oldTime = getNanoTime();
+    int64 now;
+    int64 updateEnd;
+    int64 drawEnd;
+    // Start of the previous frame, 0 if it
+    // was not drawn
+    int64 frameStart = 0;
 
     int updateCount = 0;
-    bool redraw = false;
+    FrameSample sample;
 
     while(running) {
 
         // Check time
-        timeSum += (float)glfwGetTime();
-        glfwSetTime(0.0);
+        now = getNanoTime();
+        timeSum += now - oldTime;
+        oldTime = now;
         updateCount = 0;
+        sample.dropped = false;
         while(timeSum >= frameWait) {
 
             // Update frame
             update(tm);
-            redraw = true;
+
+            // Reduce time sum
+            timeSum -= frameWait; 
 
             // Make sure we won't be updating the frame
             // too many times
-            if(++ updateCount >= MAX_UPDATE_COUNT) {
+            if(++ updateCount >= maxUpdates) {
+
+                // Either catch up during the next frames
+                // or forget the time we are behind
+                if(carryBacklog) {
 
-                timeSum = 0;
+                    if(timeSum > frameWait * maxUpdates) {
+
+                        timeSum = frameWait * maxUpdates;
+                        sample.dropped = true;
+                    }
+                }
+                else if(timeSum >= frameWait) {
+
+                    timeSum = 0;
+                    sample.dropped = true;
+                }
                 break;
             }
-
-            // Reduce time sum
-            timeSum -= frameWait; 
         }
+        updateEnd = getNanoTime();
+        Trace::counter("Logic steps", updateCount);
 
-        // Draw
-        draw();
-        // Swap buffers
-        glfwSwapBuffers(window);
+        // Nothing has changed, so the last frame is
+        // still on the screen. Sleep until there is input
+        if(isIdle()) {
+
+            glfwWaitEventsTimeout(idleWait);
+
+            // The time slept is not a backlog, but there
+            // must be a step to handle the input
+            oldTime = getNanoTime();
+            timeSum = frameWait;
+            frameStart = 0;
+        }
+        else {
+
+            // Draw the part of the step that has passed
+            graph->setInterpolation(interpolate ? 
+                (float)std::min((double)timeSum / frameWait, 1.0) : 1.0f);
+
+            // Draw
+            draw();
+            drawEnd = getNanoTime();
+            // Swap buffers
+            Profiler::begin("Swap");
+            glfwSwapBuffers(window);
+            Profiler::end();
+            Profiler::endFrame();
+
+            // Record times
+            if(stats != NULL && frameStart > 0) {
+
+                sample.frame = now - frameStart;
+                sample.update = updateEnd - now;
+                sample.draw = drawEnd - updateEnd;
+                sample.swap = getNanoTime() - drawEnd;
+                sample.ticks = updateCount;
+                stats->record(sample);
+            }
+            frameStart = now;
+        }
+        checkStatsRequest();
+        checkFileChanges();
 
         // Window closed
         if(glfwWindowShouldClose(window)) {
@@ -188,17 +394,417 @@ void Application::loop() {
 }
 
 
+// Event loop with a separate simulation thread
+void Application::loopThreaded() {
+
+    // Time to wait if there is nothing new to draw
+    const int IDLE_WAIT = 1;
+
+    std::thread sim(&Application::simulate, this);
+
+    bool fresh;
+    bool idle;
+    // Times in nanoseconds
+    int64 now;
+    int64 drawStart = 0;
+    int64 drawEnd = 0;
+    int64 frameStart = 0;
+    // Logic steps are timed on their own thread
+    FrameSample sample;
+    sample.update = 0;
+    sample.dropped = false;
+    int lastTick = 0;
+    while(running) {
+
+        now = getNanoTime();
+        {
+            std::lock_guard<std::mutex> lock(sceneLock);
+
+            // Input goes to the scenes, so it is handled
+            // while the simulation is not running
+            glfwPollEvents();
+            if(fullscreenRequest.exchange(false)) {
+
+                setFullscreen();
+            }
+        }
+
+        // Only draw if the simulation has moved on,
+        // or if there is something to interpolate
+        fresh = ticks.fetch();
+        if(interpolate) {
+
+            graph->setInterpolation(
+                tickFraction(ticks.getReadSlot()));
+            fresh = fresh || ticks.getReadSlot().tick > 0;
+        }
+        // Or if nothing has changed. The scenes
+        // drawn are the copies published last, so
+        // the simulation is not held up
+        idle = ticks.getReadSlot().idle && !redraw;
+        if(fresh && !idle) {
+
+            drawStart = getNanoTime();
+            draw();
+            drawEnd = getNanoTime();
+        }
+
+        // Swapping may wait for the vertical blank,
+        // the simulation keeps going meanwhile
+        if(fresh && !idle) {
+
+            Profiler::begin("Swap");
+            glfwSwapBuffers(window);
+            Profiler::end();
+            Profiler::endFrame();
+
+            // Record times
+            if(stats != NULL && frameStart > 0) {
+
+                sample.frame = now - frameStart;
+                sample.draw = drawEnd - drawStart;
+                sample.swap = getNanoTime() - drawEnd;
+                sample.ticks = ticks.getReadSlot().tick - lastTick;
+                stats->record(sample);
+            }
+            frameStart = now;
+            lastTick = ticks.getReadSlot().tick;
+        }
+        else {
+
+            if(idle)
+                frameStart = 0;
+
+            // Input is polled with the scenes locked,
+            // so an idle wait only lasts a tick
+            std::this_thread::sleep_for(idle ?
+                std::chrono::duration<double> (ticks.getReadSlot().wait) :
+                std::chrono::duration<double> (IDLE_WAIT / 1000.0));
+        }
+        checkStatsRequest();
+        checkFileChanges();
+
+        // Window closed
+        if(glfwWindowShouldClose(window)) {
+
+            terminate();
+        }
+    }
+
+    sim.join();
+
+    // The copies may hold GL resources, so they
+    // go while the context is still current
+    for(int i = 0; i < 3; ++ i) {
+
+        ticks.getSlot(i).scenes.clear();
+    }
+}
+
+
+// Simulation thread
+void Application::simulate() {
+
+    Trace::setThreadName("Simulation");
+
+    float framerate = conf.getIntParam("framerate", 60);
+    float tm = COMPARED_FPS / framerate;
+    double frameWait = 1.0 / framerate;
+
+    int tick = 0;
+    int updateCount;
+    bool idle = false;
+    // Times in seconds, on the same clock
+    // as the render thread
+    double now;
+    double next = getNanoTime() / NS_PER_SECOND;
+    while(running) {
+
+        // Sleep until the next tick is due
+        now = getNanoTime() / NS_PER_SECOND;
+        if(now < next) {
+
+            std::this_thread::sleep_for(
+                std::chrono::duration<double> (next - now));
+            continue;
+        }
+
+        updateCount = 0;
+        while(now >= next && running) {
+
+            {
+                std::lock_guard<std::mutex> lock(sceneLock);
+                update(tm);
+                // The render thread adds its own
+                // reasons to redraw
+                idle = lowPower && idleSteps >= IDLE_STEPS;
+            }
+            ++ tick;
+            next += frameWait;
+
+            // Make sure we won't be updating the frame
+            // too many times
+            if(++ updateCount >= maxUpdates) {
+
+                // Either catch up during the next rounds
+                // or forget the time we are behind
+                if(carryBacklog) {
+
+                    if(next < now - frameWait * maxUpdates)
+                        next = now - frameWait * maxUpdates;
+                }
+                else if(now >= next) {
+
+                    next = now + frameWait;
+                }
+                break;
+            }
+        }
+
+        // Tell the render thread. It draws copies of
+        // the scenes, so that it never waits for
+        // the next tick
+        TickInfo &info = ticks.getWriteSlot();
+        {
+            std::lock_guard<std::mutex> lock(sceneLock);
+            sceneMan->copyState(info.scenes);
+        }
+        info.tick = tick;
+        info.time = next - frameWait;
+        info.wait = frameWait;
+        info.idle = idle;
+        ticks.publish();
+    }
+}
+
+
+// How far the render thread is past the given tick
+float Application::tickFraction(const TickInfo &info) {
+
+    double t = (getNanoTime() / NS_PER_SECOND - info.time) / info.wait;
+    return (float)fmax(0.0, fmin(t, 1.0));
+}
+
+
+// Event loop without a window
+void Application::loopHeadless() {
+
+    // Every frame is one logic step, so the
+    // output does not depend on the speed
+    float framerate = conf.getIntParam("framerate", 60);
+    float tm = COMPARED_FPS / framerate;
+
+    // Times in nanoseconds
+    int64 start = getNanoTime();
+    int64 now;
+    int64 updateEnd;
+    int64 frameStart = 0;
+    // Nothing is swapped
+    FrameSample sample;
+    sample.swap = 0;
+    sample.ticks = 1;
+    sample.dropped = false;
+    while(running) {
+
+        now = getNanoTime();
+        update(tm);
+        updateEnd = getNanoTime();
+        draw();
+
+        // Record times
+        if(stats != NULL && frameStart > 0) {
+
+            sample.frame = now - frameStart;
+            sample.update = updateEnd - now;
+            sample.draw = getNanoTime() - updateEnd;
+            stats->record(sample);
+        }
+        frameStart = now;
+
+        dumpFrame();
+        Profiler::endFrame();
+        checkStatsRequest();
+
+        if(frameLimit > 0 && frameCount >= frameLimit) {
+
+            terminate();
+        }
+        glfwPollEvents();
+    }
+
+    // Wait for the GPU before reading the time
+    glFinish();
+    double time = (getNanoTime() - start) / NS_PER_SECOND;
+    printf("Drew %d frames in %.3f s (%.3f ms/frame, %.1f FPS)\n",
+        frameCount, time, 
+        frameCount > 0 ? time * 1000.0 / frameCount : 0.0,
+        time > 0.0 ? frameCount / time : 0.0);
+}
+
+
+// Write the frame statistics
+void Application::saveFrameStats() {
+
+    if(stats->write(statsPath)) {
+
+        printf("Frame statistics of %lu frames written to %s\n",
+            (unsigned long)stats->getFrameCount(), statsPath.c_str());
+    }
+    else {
+
+        printf("Warning: could not write frame statistics to %s\n",
+            statsPath.c_str());
+    }
+}
+
+
+// Write the frame statistics, if requested
+void Application::checkStatsRequest() {
+
+    if(statsRequest.exchange(false) && stats != NULL) {
+
+        saveFrameStats();
+    }
+}
+
+
+// Get the directory of a file, with the
+// trailing slash
+static std::string getDirectory(std::string path) {
+
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash+1);
+}
+
+
+// Start watching the files, if wanted
+void Application::initHotReload() {
+
+    reload = NULL;
+    if(conf.getIntParam("hot_reload", 0) != 1)
+        return;
+
+    reload = new HotReload(assets);
+    if(!reload->isEnabled()) {
+
+        printf("Warning: hot reloading is not supported here\n");
+        delete reload;
+        reload = NULL;
+        return;
+    }
+
+    // Everything in the asset directory, and
+    // the configuration files
+    std::string assetDir = getDirectory(conf.getParam("asset_path"));
+    std::vector<std::string> dirs;
+    dirs.push_back(getDirectory(cfgPath));
+    dirs.push_back(getDirectory(conf.getParam("controls_path")));
+    if(!reload->watch(assetDir, true)) {
+
+        printf("Warning: cannot watch %s\n", assetDir.c_str());
+    }
+    for(int i = 0; i < dirs.size(); ++ i) {
+
+        if(dirs[i] == assetDir ||
+           std::find(dirs.begin(), dirs.begin() + i, dirs[i]) 
+                != dirs.begin() + i) 
+            continue;
+
+        reload->watch(dirs[i]);
+    }
+}
+
+
+// Reload the changed files
+void Application::checkFileChanges() {
+
+    if(reload == NULL) return;
+
+    std::vector<std::string> changed;
+    reload->poll(changed);
+
+    std::string path;
+    for(int i = 0; i < changed.size(); ++ i) {
+
+        path = changed[i];
+
+        // Loaded once, at the start
+        if(path == cfgPath || path == conf.getParam("asset_path")) {
+
+            printf("%s changed, restart to apply it\n", path.c_str());
+            continue;
+        }
+
+        // The scenes may be updating on another thread
+        std::lock_guard<std::mutex> lock(sceneLock);
+        if(path == conf.getParam("controls_path")) {
+
+            try {
+
+                vpad = GamePad(path);
+                vpad.initInput(evMan);
+                printf("Reloaded %s\n", path.c_str());
+            }
+            catch(std::runtime_error err) {
+
+                printf("Warning: could not reload %s: %s\n",
+                    path.c_str(), err.what());
+            }
+        }
+        else {
+
+            sceneMan->fileChanged(path);
+        }
+        redraw = true;
+    }
+
+    // One texture upload per frame at most, so
+    // that reloading never delays a frame much
+    if(reload->uploadNext())
+        redraw = true;
+}
+
+
+// Save the current frame, if wanted
+void Application::dumpFrame() {
+
+    for(int i = 0; i < dumpFrames.size(); ++ i) {
+
+        if(dumpFrames[i] != frameCount)
+            continue;
+
+        std::string path = dumpPath + "frame" + intToString(frameCount) + 
+            (dumpRaw ? ".rgba" : ".png");
+        target->save(path, dumpRaw);
+        break;
+    }
+}
+
+
 // Update
-void Application::update(int steps) {
+void Application::update(float tm) {
     
     // Update gamepad
     vpad.update(evMan);
 
     // Update scenes
-    sceneMan->update(steps);
+    sceneMan->update(tm);
+    // Game time passed, for the audio
+    // drivers that follow it
+    evMan->getAudioManager()->update(tm * 1000.0f / COMPARED_FPS);
 
     // Update input
     evMan->updateInput();
+
+    // Check if anything is going on
+    if(sceneMan->isAnimating() || evMan->checkInputChange()) {
+
+        idleSteps = 0;
+    }
+    else if(idleSteps < IDLE_STEPS) {
+
+        ++ idleSteps;
+    }
 }
 
 
@@ -206,10 +812,35 @@ void Application::update(int steps) {
 void Application::draw() {
 
     // Draw scenes
-    sceneMan->draw(graph);
+    if(threaded)
+        ticks.getReadSlot().scenes.draw(graph);
+    else
+        sceneMan->draw(graph);
+    redraw = false;
+    // Draw the queued content, reset the layer
+    // and the matrix stack
+    Profiler::begin("Submit");
+    graph->endFrame();
+    Profiler::end();
+
+    // Count state changes per frame
+    GLState::endFrame();
+    Trace::counter("GL state changes", GLState::getIssued());
+    // Keep the textures in the budget
+    TextureBudget::endFrame();
+    ++ frameCount;
+    if(glStats && frameCount % 60 == 0) {
+
+        printf("GL state changes: %d issued, %d skipped\n",
+            GLState::getIssued(), GLState::getSkipped());
+        printf("Texture memory: %d kB, %d evicted so far\n",
+            (int)(TextureBudget::getUsed() / 1024),
+            TextureBudget::getEvictions());
+    }
+    if(profile && frameCount % 60 == 0) {
 
-    // Reset graphics matrix stack
-    graph->resetStack();
+        Profiler::print();
+    }
 }
 
 
@@ -223,7 +854,21 @@ void Application::dispose() {
     delete evMan;
     delete sceneMan;
     delete graph;
+    delete reload;
     delete assets;
+    delete target;
+    Profiler::disable();
+
+    // Finish the trace. Every other thread
+    // has stopped by now
+    Trace::dispose();
+
+    // Write the final frame statistics
+    if(stats != NULL) {
+
+        saveFrameStats();
+        delete stats;
+    }
 
     // Destroy window
     glfwDestroyWindow(window);
@@ -245,18 +890,44 @@ Application::Application(std::string cfgPath, std::vector<SceneInfo> scenes) {
 
     // Store scenes for future use
     this->scenes = scenes;
+    this->cfgPath = cfgPath;
 }
 
 
 // Run
 int Application::run(int argc, char ** argv) {
 
+    // Command line overrides the configuration
+    conf.parseArgs(argc, argv);
+
     try {
 
+        // Build the asset archive instead of running
+        std::string pack = conf.getParam("pack", "");
+        if(pack.length() > 0) {
+
+            Packer::pack(conf.getParam("asset_path"),
+                conf.getParam("tilemap_path", "Assets/Tilemaps/"),
+                pack == "1" ? conf.getParam("archive_path") : pack);
+            return 0;
+        }
+        // Compile the stages
+        if(conf.getIntParam("compile_maps", 0) == 1) {
+
+            Packer::compileMaps(
+                conf.getParam("tilemap_path", "Assets/Tilemaps/"));
+            return 0;
+        }
+
         // Initialize
         init();
         // Loop
-        loop();
+        if(headless)
+            loopHeadless();
+        else if(threaded)
+            loopThreaded();
+        else
+            loop();
 
         // Dispose data
         dispose();
@@ -278,9 +949,31 @@ void Application::terminate() {
 }
 
 
+// Write the frame statistics
+void Application::writeFrameStats() {
+
+    // Frames are recorded on the main thread
+    statsRequest = true;
+}
+
+
 // Toggle fullscreen
 void Application::toggleFullscreen() {
 
+    // Window functions may only be called from
+    // the main thread
+    if(threaded) {
+
+        fullscreenRequest = true;
+        return;
+    }
+    setFullscreen();
+}
+
+
+// Switch between fullscreen and windowed mode
+void Application::setFullscreen() {
+
     fullscreen = !fullscreen;
     if(fullscreen) {
 
@@ -317,4 +1010,5 @@ void Application::resize(int width, int height) {
     winSize[0] = width;
     winSize[1] = height;
     graph->resize(winSize[0], winSize[1]);
+    redraw = true;
 }
@@ -6,6 +6,8 @@
 
 #include <vector>
 #include <cstdio>
+#include <atomic>
+#include <mutex>
 
 #include "EventManager.hpp"
 #include "Graphics.hpp"
@@ -14,6 +16,12 @@
 #include "Config.hpp"
 #include "AssetPack.hpp"
 #include "GamePad.hpp"
+#include "GLState.hpp"
+#include "Framebuffer.hpp"
+#include "Profiler.hpp"
+#include "TripleBuffer.hpp"
+#include "FrameStats.hpp"
+#include "HotReload.hpp"
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -21,6 +29,38 @@
 
 typedef int WeakVec2Int[2];
 
+// Nanoseconds per second
+static const double NS_PER_SECOND = 1000000000.0;
+// Frame rate the time steps are relative to,
+// a step of 1.0 is one frame at this rate
+static const float COMPARED_FPS = 60.0f;
+
+// Steps without changes before drawing stops.
+// The interpolated frame of the last change
+// needs one more step to settle
+static const int IDLE_STEPS = 2;
+
+
+// Simulation state published to the
+// render thread in threaded mode
+struct TickInfo {
+
+    // Ticks simulated so far
+    int tick;
+    // When the latest tick was due, in seconds
+    // on the getNanoTime clock
+    double time;
+    // Time between the ticks
+    double wait;
+    // Can drawing be skipped
+    bool idle;
+    // Copies of the scenes after the tick
+    SceneSnapshot scenes;
+
+    // Constructor
+    inline TickInfo() { tick = 0; time = 0.0; wait = 1.0; idle = false; }
+};
+
 
 // Application class
 class Application {
@@ -45,6 +85,7 @@ private:
     std::vector<SceneInfo> scenes;
     // Configuration
     ConfigData conf;
+    std::string cfgPath;
 
     // Is full screen enabled
     bool fullscreen;
@@ -54,7 +95,61 @@ private:
     WeakVec2Int winSize;
 
     // Is running
-    bool running;
+    std::atomic<bool> running;
+    // Threaded mode: the simulation runs on
+    // its own thread
+    bool threaded;
+    // Held while the scenes are updated, and while
+    // input or file changes reach them
+    std::mutex sceneLock;
+    // Latest tick of the simulation thread
+    TripleBuffer<TickInfo> ticks;
+    // Fullscreen toggle waiting for the main thread
+    std::atomic<bool> fullscreenRequest;
+    // Logic steps allowed per frame before the
+    // loop gives up on catching up
+    int maxUpdates;
+    // Keep the time left over after giving up,
+    // instead of dropping it
+    bool carryBacklog;
+    // Draw between the logic steps
+    bool interpolate;
+    // Low-power mode: stop drawing while
+    // nothing changes
+    bool lowPower;
+    // Time to wait for input when idle, in seconds
+    double idleWait;
+    // Logic steps since anything changed
+    int idleSteps;
+    // Must the next frame be drawn anyway
+    bool redraw;
+    // Print GL state counters
+    bool glStats;
+    int frameCount;
+    // Print profiler results
+    bool profile;
+    // Frame statistics, NULL if not recorded
+    FrameStats* stats;
+    // File to write them to
+    std::string statsPath;
+    // Statistics waiting to be written
+    std::atomic<bool> statsRequest;
+
+    // Headless mode: nothing is shown, frames are
+    // drawn offscreen as fast as possible
+    bool headless;
+    // Offscreen target, NULL if not headless
+    Framebuffer* target;
+    // Frames to draw before quitting, 0 for no limit
+    int frameLimit;
+    // Frames to save to files
+    std::vector<int> dumpFrames;
+    std::string dumpPath;
+    bool dumpRaw;
+
+    // Reloads the changed files, NULL
+    // if not enabled
+    HotReload* reload;
   
     // Initialize GLFW & GL content
     void initGL();
@@ -63,9 +158,37 @@ private:
     void init();
     // Event loop
     void loop();
+    // Event loop without a window
+    void loopHeadless();
+    // Event loop with a separate simulation thread
+    void loopThreaded();
+    // Simulation thread
+    void simulate();
+    // How far the render thread is past the
+    // given tick, in [0,1]
+    float tickFraction(const TickInfo &info);
+    // Switch between fullscreen and windowed mode.
+    // Main thread only
+    void setFullscreen();
+    // Save the current frame, if wanted
+    void dumpFrame();
+    // Write the frame statistics
+    void saveFrameStats();
+    // Write the frame statistics, if requested
+    void checkStatsRequest();
+    // Start watching the files, if wanted
+    void initHotReload();
+    // Reload the changed files. Main thread only
+    void checkFileChanges();
     // Update
-    void update(int steps);
-    // Render
+    void update(float tm);
+    // Can drawing be skipped
+    inline bool isIdle() {
+
+        return lowPower && !redraw && idleSteps >= IDLE_STEPS;
+    }
+    // Render. Threaded mode draws the scenes
+    // published last
     void draw();
     // Dispose
     void dispose();
@@ -81,9 +204,16 @@ public:
     void terminate();
     // Toggle fullscreen
     void toggleFullscreen();
+    // Write the frame statistics, if recorded
+    void writeFrameStats();
 
     // Resize event
     void resize(int width, int height);
+    // Make sure the next frame is drawn
+    inline void invalidate() {
+
+        redraw = true;
+    }
 
 };
 
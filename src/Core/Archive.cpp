@@ -0,0 +1,213 @@
+// Asset archive
+// (c) 2019 Jani Nykänen
+
+#include "Archive.hpp"
+
+#include "Trace.hpp"
+
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// Map a file to memory, NULL on failure. Without
+// mmap the file is read to memory instead
+static const uint8* mapFile(std::string path, uint32 &size) {
+
+#ifndef _WIN32
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return NULL;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+
+        close(fd);
+        return NULL;
+    }
+    size = (uint32)st.st_size;
+
+    void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file open
+    close(fd);
+    if(p == MAP_FAILED) return NULL;
+
+    // Everything is read during loading
+    madvise(p, size, MADV_WILLNEED);
+
+    return (const uint8*)p;
+
+#else
+
+    FILE* f = fopen(path.c_str(), "rb");
+    if(f == NULL) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8* p = NULL;
+    if(len > 0) {
+
+        size = (uint32)len;
+        p = (uint8*)malloc(size);
+        if(fread(p, 1, size, f) != size) {
+
+            free(p);
+            p = NULL;
+        }
+    }
+    fclose(f);
+
+    return p;
+
+#endif
+}
+
+
+// Unmap a file
+static void unmapFile(const uint8* data, uint32 size) {
+
+#ifndef _WIN32
+    munmap((void*)data, size);
+#else
+    free((void*)data);
+#endif
+}
+
+
+// Constructor
+Archive::Archive(std::string path) {
+
+    TraceScope trace("Archive::Archive", path.c_str());
+
+    data = mapFile(path, size);
+    if(data == NULL) {
+
+        throw std::runtime_error("Failed to open an archive in " + path);
+    }
+
+    // Check the header
+    const ArchiveHeader* h = (const ArchiveHeader*)data;
+    if(size < sizeof(ArchiveHeader) ||
+       memcmp(h->magic, ARCHIVE_MAGIC, 4) != 0 ||
+       h->version != ARCHIVE_VERSION ||
+       h->size != size ||
+       h->entryCount > (size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry)) {
+
+        unmapFile(data, size);
+        throw std::runtime_error("Not a valid archive: " + path);
+    }
+    entries = (const ArchiveEntry*)(data + sizeof(ArchiveHeader));
+    entryCount = (int)h->entryCount;
+
+    // Check the entries
+    const ArchiveEntry* e;
+    for(int i = 0; i < entryCount; ++ i) {
+
+        e = &entries[i];
+        if(e->name[ARCHIVE_NAME_LENGTH-1] != 0 ||
+           e->offset > size || e->size > size - e->offset) {
+
+            unmapFile(data, size);
+            throw std::runtime_error("Broken entry in the archive " + path);
+        }
+    }
+}
+
+
+// Destructor
+Archive::~Archive() {
+
+    unmapFile(data, size);
+}
+
+
+// Add an entry
+void ArchiveWriter::add(int type, std::string name,
+    const void* data, uint32 size,
+    int32 p0, int32 p1, int32 p2, int32 p3, int32 p4) {
+
+    if(name.length() >= ARCHIVE_NAME_LENGTH) {
+
+        throw std::runtime_error("Asset name too long for an archive: "
+            + name);
+    }
+
+    ArchiveEntry e;
+    memset(&e, 0, sizeof(ArchiveEntry));
+    strcpy(e.name, name.c_str());
+    e.type = type;
+    e.size = size;
+    e.params[0] = p0;
+    e.params[1] = p1;
+    e.params[2] = p2;
+    e.params[3] = p3;
+    e.params[4] = p4;
+
+    // Offset from the start of the blobs
+    // for now, fixed when writing
+    blobs.resize((blobs.size() + ARCHIVE_ALIGN-1) & ~(ARCHIVE_ALIGN-1));
+    e.offset = blobs.size();
+    if(size > 0) {
+
+        blobs.insert(blobs.end(), (const uint8*)data,
+            (const uint8*)data + size);
+    }
+
+    entries.push_back(e);
+}
+
+
+// Write to a file
+bool ArchiveWriter::write(std::string path) {
+
+    // Blobs begin after the directory
+    uint32 base = sizeof(ArchiveHeader) +
+        entries.size() * sizeof(ArchiveEntry);
+    base = (base + ARCHIVE_ALIGN-1) & ~(ARCHIVE_ALIGN-1);
+
+    ArchiveHeader h;
+    memcpy(h.magic, ARCHIVE_MAGIC, 4);
+    h.version = ARCHIVE_VERSION;
+    h.entryCount = entries.size();
+    h.size = base + blobs.size();
+
+    std::vector<ArchiveEntry> dir = entries;
+    for(int i = 0; i < (int)dir.size(); ++ i) {
+
+        dir[i].offset += base;
+    }
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if(f == NULL) return false;
+
+    std::vector<uint8> pad(base - sizeof(ArchiveHeader) -
+        dir.size() * sizeof(ArchiveEntry), 0);
+
+    bool ok = fwrite(&h, sizeof(ArchiveHeader), 1, f) == 1;
+    if(!dir.empty()) {
+
+        ok = ok && fwrite(&dir[0], sizeof(ArchiveEntry),
+            dir.size(), f) == dir.size();
+    }
+    if(!pad.empty()) {
+
+        ok = ok && fwrite(&pad[0], 1, pad.size(), f) == pad.size();
+    }
+    if(!blobs.empty()) {
+
+        ok = ok && fwrite(&blobs[0], 1, blobs.size(), f) == blobs.size();
+    }
+    fclose(f);
+
+    return ok;
+}
@@ -0,0 +1,119 @@
+// Asset archive
+// (c) 2019 Jani Nykänen
+
+#ifndef __ARCHIVE_H__
+#define __ARCHIVE_H__
+
+#include "Types.hpp"
+
+#include <string>
+#include <vector>
+
+// File identifier & format version
+#define ARCHIVE_MAGIC "P19A"
+#define ARCHIVE_VERSION 5
+// Blobs start at multiples of this
+#define ARCHIVE_ALIGN 16
+// Longest asset name, with the terminator
+#define ARCHIVE_NAME_LENGTH 40
+
+// Entry types
+namespace ArchiveType {
+
+    enum {
+        // RGBA8, params: width, height, texture
+        // format, mipmaps
+        Bitmap = 0,
+        // Packed RGBA8 atlas page, params: width,
+        // height, texture format
+        AtlasPage = 1,
+        // No data, params: page, x, y, width, height
+        AtlasRegion = 2,
+        // Mixer PCM, params: frequency, format, channels,
+        // priority. With frequency 0, the data is a
+        // sound file
+        Sample = 3,
+        // A music file, decoded when loaded
+        Music = 4,
+        // Compiled stage, see Tilemap::serialize
+        Tilemap = 5,
+    };
+}
+
+
+// File header
+struct ArchiveHeader {
+
+    char magic[4];
+    uint32 version;
+    uint32 entryCount;
+    // Size of the whole file, for checking
+    uint32 size;
+};
+
+// Directory entry, follows the header
+struct ArchiveEntry {
+
+    char name[ARCHIVE_NAME_LENGTH];
+    uint32 type;
+    // Blob, from the beginning of the file
+    uint32 offset;
+    uint32 size;
+    // Type specific
+    int32 params[5];
+};
+
+
+// A memory mapped asset archive. The data stays
+// mapped as long as the archive exists
+class Archive {
+
+private:
+
+    // Mapped file
+    const uint8* data;
+    uint32 size;
+    // Directory, in the mapped data
+    const ArchiveEntry* entries;
+    int entryCount;
+
+public:
+
+    // Constructor. Throws if the file cannot be
+    // opened or is not a valid archive
+    Archive(std::string path);
+    // Destructor
+    ~Archive();
+
+    // Getters
+    inline int getEntryCount() { return entryCount; }
+    inline const ArchiveEntry* getEntry(int i) { return &entries[i]; }
+    inline const uint8* getData(const ArchiveEntry* e) {
+        return data + e->offset;
+    }
+};
+
+
+// Builds an archive in memory and writes it
+class ArchiveWriter {
+
+private:
+
+    std::vector<ArchiveEntry> entries;
+    std::vector<uint8> blobs;
+
+public:
+
+    // Add an entry. The data is copied
+    void add(int type, std::string name, const void* data, uint32 size,
+        int32 p0 = 0, int32 p1 = 0, int32 p2 = 0, int32 p3 = 0, int32 p4 = 0);
+
+    // Write to a file. Returns false if the
+    // file could not be written
+    bool write(std::string path);
+
+    // Getters
+    inline int getEntryCount() { return (int)entries.size(); }
+};
+
+#endif // __ARCHIVE_H__
@@ -4,17 +4,16 @@
 #include "AssetPack.hpp"
 
 #include "Config.hpp"
+#include "Trace.hpp"
+#include "ThreadPool.hpp"
+#include "Utility.hpp"
 
+#include "../Lib/ReadPNG.hpp"
 
-// Types
-namespace AssetType {
-
-    enum {
-        Bitmap = 0,
-        Sample = 1,
-        Music = 2,
-    };
-}
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstdlib>
 
 
 // Handle special parameter
@@ -41,35 +40,139 @@ void AssetPack::handleSpecialParam(std::string key, std::string value) {
             assetType = AssetType::Music;
         }
     }
+    // Pack the following bitmaps to an atlas
+    else if(key == "atlas") {
+
+        useAtlas = value == "1";
+    }
+    // Texture format of the following bitmaps
+    else if(key == "format") {
+
+        bitmapFormat = Bitmap::parseFormat(value);
+    }
+    // Mipmap the following bitmaps
+    else if(key == "mipmap") {
+
+        useMipmap = value == "1";
+    }
+    // Priority of the following samples
+    else if(key == "priority") {
+
+        samplePriority = strToInt(value);
+    }
 }
 
-// Get a generic asset
-template <class T> T* AssetPack::getAsset(std::vector<Asset<T*> >* vec, 
-    std::string name) {
 
-    for(int i = 0; i < vec->size(); ++ i) {
+// Pack the bitmaps to the atlas
+void AssetPack::buildAtlas() {
+
+    TraceScope trace("AssetPack::buildAtlas");
+
+    std::vector<Bitmap*> regions = atlas->build();
+    for(int i = 0; i < regions.size(); ++ i) {
+
+        bitmaps.add(regions[i], atlasNames[i]);
+    }
+    atlasNames.clear();
+}
+
+
+// Decode an asset, on a worker thread
+void AssetPack::decodeAsset(AssetJob &job) {
+
+    TraceScope trace("AssetPack::decodeAsset", job.name.c_str());
+
+    try {
+
+        switch(job.type) {
+
+        case AssetType::Bitmap:
+            job.pixels = readPNG(job.path, job.width, job.height);
+            break;
 
-        if((*vec)[i].name == name) {
+        // Samples & music are decoded completely
+        case AssetType::Sample:
+            job.sample = new Sample(job.path);
+            break;
 
-            return (*vec)[i].asset;
+        case AssetType::Music:
+            job.music = new Music(job.path);
+            break;
+
+        default:
+            break;
+        }
+    }
+    catch(std::runtime_error err) {
+
+        job.error = err.what();
+    }
+}
+
+
+// Finish loading a decoded asset, on the GL thread
+void AssetPack::finishAsset(AssetJob &job) {
+
+    TraceScope trace("AssetPack::finishAsset", job.name.c_str());
+
+    if(!job.error.empty())
+        return;
+
+    switch(job.type) {
+
+    // Atlas images are uploaded once all are packed
+    case AssetType::Bitmap:
+        if(!job.atlas) {
+
+            job.bitmap = new Bitmap(job.width, job.height, job.pixels,
+                job.format, job.mipmap);
+            job.bitmap->setSource(job.path);
+            free(job.pixels);
+            job.pixels = NULL;
         }
+        break;
+
+    default:
+        break;
     }
+}
 
-    return NULL;
+
+// Free whatever a job has loaded
+void AssetPack::freeAsset(AssetJob &job) {
+
+    free(job.pixels);
+    delete job.bitmap;
+    delete job.sample;
+    delete job.music;
+
+    job.pixels = NULL;
+    job.bitmap = NULL;
+    job.sample = NULL;
+    job.music = NULL;
 }
 
 
 // Constructor
 AssetPack::AssetPack(std::string path) {
 
+    TraceScope trace("AssetPack::AssetPack", path.c_str());
+
     ConfigData data = ConfigData(path);
     
     // Create data
-    bitmaps = std::vector<Asset<Bitmap*> > ();
-
-    // Go through params
+    atlas = NULL;
+    archive = NULL;
+    useAtlas = false;
+    bitmapFormat = BitmapFormat::RGBA8;
+    useMipmap = false;
+    samplePriority = 0;
+
+    // Go through params. The special parameters
+    // affect the assets after them
+    std::vector<AssetJob> jobs;
     std::string key, value;
-    std::string assetName, assetPath;
+    AssetJob job;
     for(int i = 0; i < data.getParamCount(); ++ i) {
 
         // Check if a special parameter
@@ -82,29 +185,196 @@ AssetPack::AssetPack(std::string path) {
         else {
 
             // Set params
-            assetName = key;
-            assetPath = basePath + value;
+            job.type = assetType;
+            job.name = key;
+            job.path = basePath + value;
+            job.atlas = useAtlas;
+            job.format = bitmapFormat;
+            job.mipmap = useMipmap;
+            job.priority = samplePriority;
+            jobs.push_back(job);
+        }
+    }
+
+    // Finished jobs, in the order they finished
+    std::vector<int> done;
+    std::mutex doneLock;
+    std::condition_variable doneWake;
+    {
+        // Decode on worker threads
+        ThreadPool pool;
+        for(int i = 0; i < jobs.size(); ++ i) {
+
+            pool.submit([&, i]() {
+
+                decodeAsset(jobs[i]);
+                {
+                    std::lock_guard<std::mutex> l(doneLock);
+                    done.push_back(i);
+                }
+                doneWake.notify_one();
+            });
+        }
+
+        // Upload whatever is ready while the
+        // rest are still decoding
+        int index;
+        for(int n = 0; n < jobs.size(); ++ n) {
+
+            {
+                std::unique_lock<std::mutex> l(doneLock);
+                while(done.size() <= n) {
+
+                    doneWake.wait(l);
+                }
+                index = done[n];
+            }
+            finishAsset(jobs[index]);
+        }
+    }
 
-            // Load assets
-            switch(assetType) {
+    // If an asset failed, free the others
+    // before telling about it
+    for(int i = 0; i < jobs.size(); ++ i) {
 
-            // Load bitmap
-            case AssetType::Bitmap:
-                bitmaps.push_back(Asset<Bitmap*> (new Bitmap(assetPath), assetName));
-                break;
+        if(jobs[i].error.empty())
+            continue;
 
-            // Load sample
-            case AssetType::Sample:
-                samples.push_back(Asset<Sample*> (new Sample(assetPath), assetName));
+        std::string error = jobs[i].error;
+        for(int j = 0; j < jobs.size(); ++ j) {
 
-            // Load music
-            case AssetType::Music:
-                music.push_back(Asset<Music*> (new Music(assetPath), assetName));
+            freeAsset(jobs[j]);
+        }
+        throw std::runtime_error(error);
+    }
+
+    // Store in the order of the file, so that
+    // the atlas is always packed the same way
+    for(int i = 0; i < jobs.size(); ++ i) {
+
+        AssetJob &j = jobs[i];
+        switch(j.type) {
+
+        case AssetType::Bitmap:
+            bitmapPaths[j.path] = hashName(j.name);
+            if(j.atlas) {
 
-            default:
-                break;    
+                if(atlas == NULL)
+                    atlas = new Atlas();
+
+                atlas->add(j.pixels, j.width, j.height, j.format);
+                atlasNames.push_back(j.name);
+            }
+            else {
+
+                bitmaps.add(j.bitmap, j.name);
             }
+            break;
+
+        case AssetType::Sample:
+            j.sample->setPriority(j.priority);
+            samples.add(j.sample, j.name);
+            break;
+
+        case AssetType::Music:
+            music.add(j.music, j.name);
+            break;
+
+        default:
+            break;    
+        }
+    }
+
+    // Create the atlas textures
+    if(atlas != NULL) {
+
+        buildAtlas();
+    }
+}
+
+
+// Constructor, from an archive
+AssetPack::AssetPack(Archive* archive) {
+
+    TraceScope trace("AssetPack::AssetPack", "archive");
+
+    this->archive = archive;
+    atlas = NULL;
+
+    // Atlas regions, the white one last
+    std::vector<AtlasRegion> regions;
+    AtlasRegion r;
+
+    const ArchiveEntry* e;
+    const uint8* data;
+    Sample* sample;
+    for(int i = 0; i < archive->getEntryCount(); ++ i) {
+
+        e = archive->getEntry(i);
+        data = archive->getData(e);
+
+        TraceScope trace("AssetPack::upload", e->name);
+
+        switch(e->type) {
+
+        // Textures are uploaded from the mapped pages,
+        // and again from there if evicted
+        case ArchiveType::Bitmap:
+            bitmaps.add(new Bitmap(e->params[0], e->params[1], 
+                data, e->params[2], e->params[3] == 1), e->name);
+            bitmaps[bitmaps.size()-1]->setSource(data);
+            break;
+
+        case ArchiveType::AtlasPage:
+            if(atlas == NULL)
+                atlas = new Atlas();
+
+            atlas->addPage(data, e->params[0], e->params[1],
+                e->params[2]);
+            break;
+
+        case ArchiveType::AtlasRegion:
+            r.page = e->params[0];
+            r.x = e->params[1];
+            r.y = e->params[2];
+            r.width = e->params[3];
+            r.height = e->params[4];
+            regions.push_back(r);
+            atlasNames.push_back(e->name);
+            break;
+
+        // The mixer plays the samples from the
+        // mapped pages, too
+        case ArchiveType::Sample:
+            sample = new Sample(data, e->size, e->params[0], 
+                e->params[1], e->params[2], e->name);
+            sample->setPriority(e->params[3]);
+            samples.add(sample, e->name);
+            break;
+
+        // Decoded completely, like the samples
+        case ArchiveType::Music:
+            music.add(new Music(data, e->size, e->name), e->name);
+            break;
+
+        case ArchiveType::Tilemap:
+            tilemaps.add(new Tilemap(data, e->size), e->name);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Create the regions
+    if(atlas != NULL) {
+
+        std::vector<Bitmap*> out = atlas->createRegions(regions);
+        for(int i = 0; i < out.size(); ++ i) {
+
+            bitmaps.add(out[i], atlasNames[i]);
         }
+        atlasNames.clear();
     }
 }
 
@@ -115,39 +385,57 @@ AssetPack::~AssetPack() {
     // Destroy bitmaps
     for(int i = 0; i < bitmaps.size(); ++ i) {
 
-        delete bitmaps[i].asset;
+        delete bitmaps[i];
     }
 
     // Destroy samples
     for(int i = 0; i < samples.size(); ++ i) {
 
-        delete samples[i].asset;
+        delete samples[i];
     }
 
     // Destroy music
     for(int i = 0; i < music.size(); ++ i) {
 
-        delete music[i].asset;
+        delete music[i];
     }
-}
 
+    // Destroy tilemaps
+    for(int i = 0; i < tilemaps.size(); ++ i) {
 
-// Get a bitmap by its name
-Bitmap* AssetPack::getBitmap(std::string name) {
+        delete tilemaps[i];
+    }
+
+    // Destroy atlas textures
+    delete atlas;
 
-    return getAsset<Bitmap>(&bitmaps, name);
+    // Unmap the archive last, since the
+    // assets may still point to it
+    delete archive;
 }
 
 
-// Get a sample by its name
-Sample* AssetPack::getSample(std::string name) {
+// Get the white atlas region
+Bitmap* AssetPack::getWhiteBitmap() {
 
-    return getAsset<Sample>(&samples, name);
+    return atlas == NULL ? NULL : atlas->getWhite();
 }
 
 
-// Get a music track by its name
-Music* AssetPack::getMusic(std::string name) {
+// Replace the content of a bitmap
+void AssetPack::reloadBitmap(std::string path, const uint8* data,
+    int width, int height) {
+
+    TraceScope trace("AssetPack::reloadBitmap", path.c_str());
+
+    auto it = bitmapPaths.find(path);
+    if(it == bitmapPaths.end()) return;
+
+    Bitmap* bmp = getBitmap(it->second);
+    if(bmp == NULL) return;
 
-    return getAsset<Music> (&music, name);
+    if(bmp->isRegion())
+        atlas->replace(bmp, data, width, height);
+    else
+        bmp->replace(data, width, height);
 }
@@ -5,11 +5,28 @@
 #define __ASSET_PACK_H__
 
 #include "Bitmap.hpp"
+#include "Atlas.hpp"
 #include "Sample.hpp"
 #include "Music.hpp"
+#include "Tilemap.hpp"
+#include "Archive.hpp"
+#include "Hash.hpp"
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <stdexcept>
+
+
+// Asset types
+namespace AssetType {
+
+    enum {
+        Bitmap = 0,
+        Sample = 1,
+        Music = 2,
+    };
+}
 
 
 // Generic asset
@@ -27,40 +44,240 @@ template<class T> struct Asset {
     }
 };
 
+// Handle to an asset. Stays valid as long
+// as the pack does
+template<class T> struct AssetHandle {
+
+    int index;
+
+    // Constructor
+    explicit inline AssetHandle(int index = -1) {
+
+        this->index = index;
+    }
+    // Does it point to an asset
+    inline bool isValid() { return index >= 0; }
+};
+
+// Assets of a type, found by their name IDs
+template<class T> class AssetTable {
+
+private:
+
+    std::vector<Asset<T*> > assets;
+    // Name ID to index
+    std::unordered_map<NameID, int> index;
+
+public:
+
+    // Add an asset. Two names with the same hash
+    // are an error, since only the hash is looked
+    // up. With the same name, the first one stays
+    inline void add(T* asset, std::string name) {
+
+        NameID id = hashName(name);
+        auto it = index.find(id);
+        if(it != index.end()) {
+
+            if(assets[it->second].name != name) {
+
+                throw std::runtime_error("Asset names " + 
+                    assets[it->second].name + " and " + name + 
+                    " have the same hash");
+            }
+        }
+        else {
+
+            index[id] = (int)assets.size();
+        }
+        assets.push_back(Asset<T*> (asset, name));
+    }
+
+    // Find an asset
+    inline AssetHandle<T> find(NameID id) {
+
+        auto it = index.find(id);
+        return AssetHandle<T> (it == index.end() ? -1 : it->second);
+    }
+
+    // Get an asset by its handle, NULL
+    // if the handle is not valid
+    inline T* get(AssetHandle<T> h) {
+
+        return h.isValid() ? assets[h.index].asset : NULL;
+    }
+
+    // Getters
+    inline int size() { return (int)assets.size(); }
+    inline T* operator[] (int i) { return assets[i].asset; }
+};
+
+// An asset being loaded
+struct AssetJob {
+
+    int type;
+    std::string name;
+    std::string path;
+    // Goes to the atlas
+    bool atlas;
+    // Texture format & mipmaps
+    int format;
+    bool mipmap;
+    // Sample priority
+    int priority;
+
+    // Decoded bitmap, from malloc
+    uint8* pixels;
+    int width;
+    int height;
+
+    // Results
+    Bitmap* bitmap;
+    Sample* sample;
+    Music* music;
+    // Set if decoding failed
+    std::string error;
+
+    // Constructor
+    inline AssetJob() {
+
+        type = 0;
+        atlas = false;
+        format = BitmapFormat::RGBA8;
+        mipmap = false;
+        priority = 0;
+        pixels = NULL;
+        width = 0;
+        height = 0;
+        bitmap = NULL;
+        sample = NULL;
+        music = NULL;
+    }
+};
+
 // Asset pack
 class AssetPack {
 
 private:
 
     // Assets
-    std::vector<Asset<Bitmap*> > bitmaps;
-    std::vector<Asset<Sample*> > samples;
-    std::vector<Asset<Music*> > music;
+    AssetTable<Bitmap> bitmaps;
+    AssetTable<Sample> samples;
+    AssetTable<Music> music;
+    // Only archives have tilemaps
+    AssetTable<Tilemap> tilemaps;
+
+    // The archive the assets are in, if any
+    Archive* archive;
+
+    // Files the loose bitmaps were loaded from
+    std::unordered_map<std::string, NameID> bitmapPaths;
+
+    // Atlas, if enabled
+    Atlas* atlas;
+    // Bitmaps waiting for the atlas
+    std::vector<std::string> atlasNames;
 
     // Needed for parsing
     std::string basePath;
     int assetType;
+    bool useAtlas;
+    int bitmapFormat;
+    bool useMipmap;
+    int samplePriority;
+
+    // Pack the bitmaps to the atlas
+    void buildAtlas();
+    // Decode an asset. Called from worker
+    // threads, so no GL calls here
+    static void decodeAsset(AssetJob &job);
+    // Finish loading a decoded asset, on the
+    // thread that owns the GL context. Failed
+    // assets are skipped
+    static void finishAsset(AssetJob &job);
+    // Free whatever a job has loaded
+    static void freeAsset(AssetJob &job);
 
     // Handle special parameter
     void handleSpecialParam(std::string key, std::string value);
 
-    // Get a generic asset
-    template <class T> T* getAsset(std::vector<Asset<T*> >* vec, 
-            std::string name);
-
 public:
 
-    // Constructor
+    // Constructor, loads the assets listed
+    // in a config file
     AssetPack(std::string path);
+    // Constructor, uploads the assets straight from
+    // an archive. The pack takes the archive
+    AssetPack(Archive* archive);
     // Desctructor
     ~AssetPack();
 
-    // Get a bitmap by its name
-    Bitmap* getBitmap(std::string name);
-    // Get a sample by its name
-    Sample* getSample(std::string name);
-    // Get a music track by its name
-    Music* getMusic(std::string name);
+    // Find assets by their name IDs. Use NAME_ID
+    // to hash literals at compile time
+    inline AssetHandle<Bitmap> findBitmap(NameID id) {
+        return bitmaps.find(id);
+    }
+    inline AssetHandle<Sample> findSample(NameID id) {
+        return samples.find(id);
+    }
+    inline AssetHandle<Music> findMusic(NameID id) {
+        return music.find(id);
+    }
+
+    // Get assets by their handles
+    inline Bitmap* getBitmap(AssetHandle<Bitmap> h) { 
+        return bitmaps.get(h); 
+    }
+    inline Sample* getSample(AssetHandle<Sample> h) {
+        return samples.get(h);
+    }
+    inline Music* getMusic(AssetHandle<Music> h) {
+        return music.get(h);
+    }
+
+    // Get assets by their name IDs
+    inline Bitmap* getBitmap(NameID id) { 
+        return bitmaps.get(bitmaps.find(id)); 
+    }
+    inline Sample* getSample(NameID id) {
+        return samples.get(samples.find(id));
+    }
+    inline Music* getMusic(NameID id) {
+        return music.get(music.find(id));
+    }
+
+    // Get assets by their names
+    inline Bitmap* getBitmap(std::string name) {
+        return getBitmap(hashName(name));
+    }
+    inline Sample* getSample(std::string name) {
+        return getSample(hashName(name));
+    }
+    inline Music* getMusic(std::string name) {
+        return getMusic(hashName(name));
+    }
+
+    // Get a tilemap, NULL if not in the pack
+    inline Tilemap* getTilemap(NameID id) {
+        return tilemaps.get(tilemaps.find(id));
+    }
+    inline Tilemap* getTilemap(std::string name) {
+        return getTilemap(hashName(name));
+    }
+
+    // Get the white atlas region, NULL if
+    // there is no atlas
+    Bitmap* getWhiteBitmap();
+
+    // Is a file the source of a bitmap
+    inline bool isBitmapSource(std::string path) {
+        return bitmapPaths.find(path) != bitmapPaths.end();
+    }
+    // Replace the content of the bitmap loaded from
+    // a file with an RGBA image. Throws if an atlas
+    // image changes its size
+    void reloadBitmap(std::string path, const uint8* data,
+        int width, int height);
 };
 
 #endif // __ASSET_PACK_H__
@@ -0,0 +1,397 @@
+// Texture atlas
+// (c) 2019 Jani Nykänen
+
+#include "Atlas.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <GL/gl.h>
+
+#include "../Lib/ReadPNG.hpp"
+
+// Padding around every image
+static const int PADDING = 2;
+// Size of the white region
+static const int WHITE_SIZE = 4;
+
+
+// Sorts image indices by height, tallest first
+struct HeightOrder {
+
+    std::vector<AtlasImage>* images;
+
+    inline bool operator()(int a, int b) const {
+
+        return (*images)[a].height > (*images)[b].height;
+    }
+};
+
+
+// Find a place for a rectangle in the skyline
+int Atlas::findPlace(std::vector<SkylineNode> &sky,
+    int w, int h, int &x, int &y) {
+
+    int best = -1;
+    int bestY = pageSize;
+    int bestX = pageSize;
+
+    int top, left, j;
+    for(int i = 0; i < (int)sky.size(); ++ i) {
+
+        left = sky[i].x;
+        if(left + w > pageSize)
+            break;
+
+        // Find the highest node under the rectangle
+        top = 0;
+        for(j = i; j < (int)sky.size() && sky[j].x < left + w; ++ j) {
+
+            top = std::max(top, sky[j].y);
+        }
+        if(top + h > pageSize)
+            continue;
+
+        // Prefer low positions, then the left side
+        if(top < bestY || (top == bestY && left < bestX)) {
+
+            best = i;
+            bestY = top;
+            bestX = left;
+        }
+    }
+
+    x = bestX;
+    y = bestY;
+    return best;
+}
+
+
+// Add a rectangle to the skyline
+void Atlas::addToSkyline(std::vector<SkylineNode> &sky,
+    int index, int x, int y, int w, int h) {
+
+    sky.insert(sky.begin() + index, SkylineNode(x, y + h, w));
+
+    // Cut the nodes under the new one
+    int shrink;
+    for(int i = index+1; i < (int)sky.size(); ) {
+
+        if(sky[i].x >= x + w)
+            break;
+
+        shrink = x + w - sky[i].x;
+        sky[i].x += shrink;
+        sky[i].width -= shrink;
+        if(sky[i].width > 0)
+            break;
+
+        sky.erase(sky.begin() + i);
+    }
+
+    // Merge nodes on the same level
+    for(int i = 0; i < (int)sky.size()-1; ) {
+
+        if(sky[i].y == sky[i+1].y) {
+
+            sky[i].width += sky[i+1].width;
+            sky.erase(sky.begin() + i+1);
+        }
+        else {
+
+            ++ i;
+        }
+    }
+}
+
+
+// Copy an image to a buffer, extruding the edges
+// to the padding. The position is of the image
+static void extrude(uint8* out, int stride, int ox, int oy,
+    const uint8* in, int width, int height) {
+
+    int sx, sy;
+    for(int y = -PADDING; y < height + PADDING; ++ y) {
+
+        sy = std::min(std::max(y, 0), height-1);
+        for(int x = -PADDING; x < width + PADDING; ++ x) {
+
+            sx = std::min(std::max(x, 0), width-1);
+            memcpy(&out[((oy + y) * stride + ox + x) * 4],
+                &in[(sy * width + sx) * 4], 4);
+        }
+    }
+}
+
+
+// Copy an image to a page
+void Atlas::blit(uint8* page, AtlasImage &img) {
+
+    extrude(page, pageSize, img.x, img.y, img.data, img.width, img.height);
+}
+
+
+// Constructor
+Atlas::Atlas(int pageSize) {
+
+    white = NULL;
+
+    if(pageSize <= 0) {
+
+        int maxSize = ATLAS_MAX_PAGE_SIZE;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        pageSize = std::min(maxSize, ATLAS_MAX_PAGE_SIZE);
+    }
+    this->pageSize = pageSize;
+}
+
+
+// Destructor
+Atlas::~Atlas() {
+
+    for(int i = 0; i < (int)images.size(); ++ i) {
+
+        free(images[i].data);
+    }
+
+    for(int i = 0; i < (int)pages.size(); ++ i) {
+
+        delete pages[i];
+    }
+    delete white;
+}
+
+
+// Add an image
+void Atlas::add(std::string path) {
+
+    int w, h;
+    uint8* data = readPNG(path, w, h);
+    add(data, w, h);
+}
+void Atlas::add(uint8* data, int width, int height, int format) {
+
+    AtlasImage img;
+    img.data = data;
+    img.width = width;
+    img.height = height;
+    img.format = format;
+    img.page = -1;
+    img.x = 0;
+    img.y = 0;
+
+    images.push_back(img);
+}
+
+
+// Pack the images to pages
+void Atlas::pack(std::vector<AtlasPage> &outPages,
+    std::vector<AtlasRegion> &outRegions) {
+
+    // Add the white region as the last image. White
+    // is exact in every format, so it joins the first
+    // image to not need a page of its own
+    AtlasImage w;
+    w.width = WHITE_SIZE;
+    w.height = WHITE_SIZE;
+    w.format = images.empty() ? BitmapFormat::RGBA8 : images[0].format;
+    w.data = (uint8*)malloc(WHITE_SIZE*WHITE_SIZE*4);
+    memset(w.data, 255, WHITE_SIZE*WHITE_SIZE*4);
+    w.page = -1;
+    w.x = 0;
+    w.y = 0;
+    images.push_back(w);
+
+    // Pack the tallest images first
+    std::vector<int> order;
+    for(int i = 0; i < (int)images.size(); ++ i) {
+
+        order.push_back(i);
+    }
+    HeightOrder cmp;
+    cmp.images = &images;
+    std::stable_sort(order.begin(), order.end(), cmp);
+
+    std::vector<SkylineNode> sky;
+    std::vector<int> pageImages;
+    AtlasPage page;
+    int left = (int)images.size();
+    int x, y, node;
+    AtlasImage* img;
+    while(left > 0) {
+
+        sky.clear();
+        sky.push_back(SkylineNode(0, 0, pageSize));
+        pageImages.clear();
+        page.height = 0;
+
+        // The page gets the format of the
+        // tallest image left
+        for(int i = 0; i < (int)order.size(); ++ i) {
+
+            if(images[order[i]].page < 0) {
+
+                page.format = images[order[i]].format;
+                break;
+            }
+        }
+
+        for(int i = 0; i < (int)order.size(); ++ i) {
+
+            img = &images[order[i]];
+            if(img->page >= 0 || img->format != page.format)
+                continue;
+
+            node = findPlace(sky, img->width + PADDING*2,
+                img->height + PADDING*2, x, y);
+            if(node < 0)
+                continue;
+
+            addToSkyline(sky, node, x, y,
+                img->width + PADDING*2, img->height + PADDING*2);
+
+            img->page = (int)outPages.size();
+            img->x = x + PADDING;
+            img->y = y + PADDING;
+            page.height = std::max(page.height, 
+                y + img->height + PADDING*2);
+
+            pageImages.push_back(order[i]);
+            -- left;
+        }
+
+        // Too big for a page, make it a page of
+        // its own. The page takes the data
+        if(pageImages.empty()) {
+
+            for(int i = 0; i < (int)order.size(); ++ i) {
+
+                img = &images[order[i]];
+                if(img->page < 0 && img->format == page.format) {
+
+                    img->page = (int)outPages.size();
+                    page.data = img->data;
+                    page.width = img->width;
+                    page.height = img->height;
+                    outPages.push_back(page);
+
+                    img->data = NULL;
+                    -- left;
+                    break;
+                }
+            }
+            continue;
+        }
+
+        // Create the page. Unused rows at the
+        // bottom are left out
+        page.width = pageSize;
+        page.data = (uint8*)calloc(pageSize*page.height*4, 1);
+        for(int i = 0; i < (int)pageImages.size(); ++ i) {
+
+            blit(page.data, images[pageImages[i]]);
+        }
+        outPages.push_back(page);
+    }
+
+    // Store the regions
+    AtlasRegion r;
+    for(int i = 0; i < (int)images.size(); ++ i) {
+
+        img = &images[i];
+        r.page = img->page;
+        r.x = img->x;
+        r.y = img->y;
+        r.width = img->width;
+        r.height = img->height;
+        outRegions.push_back(r);
+
+        free(img->data);
+    }
+    images.clear();
+}
+
+
+// Create a page texture
+void Atlas::addPage(const uint8* data, int width, int height,
+    int format) {
+
+    // Images too big for a page may have a
+    // page of their own, so the GPU decides
+    int maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if(width > maxSize || height > maxSize) {
+
+        throw std::runtime_error("Atlas page too large for the GPU");
+    }
+    pages.push_back(new Bitmap(width, height, data, format));
+    pages.back()->setSource(data);
+}
+
+
+// Create the regions of the pages added
+std::vector<Bitmap*> Atlas::createRegions(
+    const std::vector<AtlasRegion> &regions) {
+
+    std::vector<Bitmap*> out;
+    for(int i = 0; i < (int)regions.size(); ++ i) {
+
+        const AtlasRegion &r = regions[i];
+        if(r.page < 0 || r.page >= (int)pages.size()) {
+
+            throw std::runtime_error("Atlas region without a page");
+        }
+        out.push_back(new Bitmap(pages[r.page],
+            r.x, r.y, r.width, r.height));
+    }
+
+    // The white region is not returned
+    if(!out.empty()) {
+
+        white = out.back();
+        out.pop_back();
+    }
+
+    return out;
+}
+
+
+// Pack the images & create the textures
+std::vector<Bitmap*> Atlas::build() {
+
+    std::vector<AtlasPage> packed;
+    std::vector<AtlasRegion> regions;
+    pack(packed, regions);
+
+    for(int i = 0; i < (int)packed.size(); ++ i) {
+
+        pages.push_back(new Bitmap(packed[i].width, packed[i].height,
+            packed[i].data, packed[i].format));
+        free(packed[i].data);
+    }
+
+    return createRegions(regions);
+}
+
+
+// Replace the content of a region
+void Atlas::replace(Bitmap* region, const uint8* data,
+    int width, int height) {
+
+    if(width != region->getWidth() || height != region->getHeight()) {
+
+        throw std::runtime_error("The size of an atlas image changed, "
+            "restart to repack the atlas");
+    }
+
+    // The padding is replaced, too. Images on pages of
+    // their own have none, that part is clipped
+    int w = width + PADDING*2;
+    int h = height + PADDING*2;
+    uint8* buffer = (uint8*)malloc(w*h*4);
+    extrude(buffer, w, PADDING, PADDING, data, width, height);
+    region->upload(buffer, -PADDING, -PADDING, w, h);
+    free(buffer);
+}
@@ -0,0 +1,144 @@
+// Texture atlas
+// (c) 2019 Jani Nykänen
+
+#ifndef __ATLAS_H__
+#define __ATLAS_H__
+
+#include "Bitmap.hpp"
+
+#include <string>
+#include <vector>
+
+// Largest page size used
+#define ATLAS_MAX_PAGE_SIZE 2048
+
+// An image waiting to be packed
+struct AtlasImage {
+
+    uint8* data;
+    int width;
+    int height;
+    // Texture format, see BitmapFormat
+    int format;
+    // Position in the page
+    int page;
+    int x;
+    int y;
+};
+
+// A packed page, before it is uploaded.
+// The data is RGBA8 in any format
+struct AtlasPage {
+
+    uint8* data;
+    int width;
+    int height;
+    int format;
+};
+
+// Where an image went
+struct AtlasRegion {
+
+    int page;
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// A skyline segment
+struct SkylineNode {
+
+    int x;
+    int y;
+    int width;
+
+    // Constructor
+    inline SkylineNode(int x = 0, int y = 0, int width = 0) {
+
+        this->x = x;
+        this->y = y;
+        this->width = width;
+    }
+};
+
+
+// Atlas class. Packs images into a few large
+// textures so that drawing them does not require
+// texture swaps
+class Atlas {
+
+private:
+
+    // Images
+    std::vector<AtlasImage> images;
+    // Pages
+    std::vector<Bitmap*> pages;
+    // White region
+    Bitmap* white;
+
+    // Page size
+    int pageSize;
+
+    // Find a place for a rectangle in the skyline.
+    // Returns the index of the first node covered,
+    // or -1 if the rectangle does not fit
+    int findPlace(std::vector<SkylineNode> &sky,
+        int w, int h, int &x, int &y);
+    // Add a rectangle to the skyline
+    void addToSkyline(std::vector<SkylineNode> &sky,
+        int index, int x, int y, int w, int h);
+
+    // Copy an image to a page, extruding the edges
+    // to the padding
+    void blit(uint8* page, AtlasImage &img);
+
+public:
+
+    // Constructor. With no page size given, the
+    // largest one the GPU supports is used, so a GL
+    // context is needed
+    Atlas(int pageSize = 0);
+    // Destructor
+    ~Atlas();
+
+    // Add an image
+    void add(std::string path);
+    // Add a decoded RGBA image. The atlas takes
+    // the data, it must come from malloc
+    void add(uint8* data, int width, int height,
+        int format = BitmapFormat::RGBA8);
+    // Pack the images to pages, without any GL calls.
+    // Each page has images of one format. The regions
+    // are in the order the images were added, followed
+    // by the white region. The caller frees the page data
+    void pack(std::vector<AtlasPage> &outPages,
+        std::vector<AtlasRegion> &outRegions);
+    // Create a page texture. Throws if the page is
+    // larger than the GPU supports. The data must stay
+    // valid, the page is restored from it if evicted
+    void addPage(const uint8* data, int width, int height,
+        int format = BitmapFormat::RGBA8);
+    // Create the regions of the pages added. The last
+    // region must be the white one, it is not returned.
+    // The caller owns the regions
+    std::vector<Bitmap*> createRegions(
+        const std::vector<AtlasRegion> &regions);
+
+    // Pack the images & create the textures. Returns
+    // the regions in the order the images were added.
+    // The caller owns the regions
+    std::vector<Bitmap*> build();
+
+    // Replace the content of a region with an RGBA
+    // image of the same size. Throws if the size
+    // differs, since the atlas is not repacked
+    void replace(Bitmap* region, const uint8* data,
+        int width, int height);
+
+    // Getters
+    inline Bitmap* getWhite() { return white; }
+    inline int getPageCount() { return (int)pages.size(); }
+};
+
+#endif // __ATLAS_H__
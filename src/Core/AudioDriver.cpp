@@ -0,0 +1,80 @@
+// Audio driver
+// (c) 2019 Jani Nykänen
+
+#include "AudioDriver.hpp"
+
+#include "SDLAudioDriver.hpp"
+#include "CaptureAudioDriver.hpp"
+
+#define SDL_MAIN_HANDLED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+
+// Destructor
+AudioDriver::~AudioDriver() {
+
+    delete mixer;
+}
+
+
+// Open SDL_mixer & create the mixer
+bool AudioDriver::openMixer() {
+
+    // Initialize SDL2
+    if(SDL_Init(SDL_INIT_AUDIO) == -1) {
+        
+        printf("Failed to initialize SDL2: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // Open audio
+    if(Mix_OpenAudio(AUDIO_FREQUENCY, MIX_DEFAULT_FORMAT, 
+        AUDIO_CHANNELS, AUDIO_CHUNK_SIZE) == -1) {
+
+        printf("Failed to open audio.\n");
+        printf("Mix_OpenAudio: %s\n", Mix_GetError());
+        return false;
+    }
+
+    // Initialize Mixer
+    int flags = MIX_INIT_OGG;
+    int ret =  Mix_Init(flags);
+    if((ret & flags) != flags) {
+
+        printf("Failed to initialize OGG addon. Music possibly disabled.\n");
+        printf("SDL_Mixer: %s\n", Mix_GetError());
+    }
+
+    // The samples & music are converted to the format
+    // the device was opened in, the frequency & channel
+    // count may differ from what was asked
+    int freq, channels;
+    Uint16 format;
+    Mix_QuerySpec(&freq, &format, &channels);
+    mixer = new AudioMixer(freq, channels);
+
+    // Only the mixer plays anything
+    Mix_AllocateChannels(0);
+
+    return true;
+}
+
+
+// Create a driver by its name
+AudioDriver* AudioDriver::create(std::string name,
+    std::string capturePath, bool realtime) {
+
+    if(name == "sdl")
+        return new SDLAudioDriver();
+    else if(name == "null")
+        return new NullAudioDriver();
+    else if(name == "capture")
+        return new CaptureAudioDriver(capturePath, realtime);
+
+    throw std::runtime_error("Unknown audio driver " + name);
+}
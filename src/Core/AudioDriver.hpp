@@ -0,0 +1,69 @@
+// Audio driver
+// (c) 2019 Jani Nykänen
+
+#ifndef __AUDIO_DRIVER_H__
+#define __AUDIO_DRIVER_H__
+
+#include "AudioMixer.hpp"
+
+#include <string>
+
+// Mixer output format
+#define AUDIO_FREQUENCY 44100
+#define AUDIO_CHANNELS 2
+#define AUDIO_CHUNK_SIZE 512
+
+
+// Sends what the mixer mixes somewhere. Opening a
+// driver creates the mixer, in the output format
+class AudioDriver {
+
+protected:
+
+    // Mixer, NULL if nothing is mixed
+    AudioMixer* mixer;
+
+    // Open SDL_mixer, which decodes the sounds, and
+    // create the mixer in its format. Returns false
+    // if it fails
+    bool openMixer();
+
+public:
+
+    // Constructor
+    inline AudioDriver() { mixer = NULL; }
+    // Destructor
+    virtual ~AudioDriver();
+
+    // Open the output. Returns false if it fails
+    virtual bool open() = 0;
+    // Stop mixing. The sounds may be freed after this
+    virtual void close() = 0;
+    // Game time passed, in milliseconds. Only for
+    // the drivers that follow the game time
+    virtual void advance(double ms) {}
+    // Name in the config
+    virtual const char* getName() = 0;
+
+    // Getters
+    inline AudioMixer* getMixer() { return mixer; }
+
+    // Create a driver by its name in the config:
+    // "sdl", "null" or "capture". Throws if unknown
+    static AudioDriver* create(std::string name,
+        std::string capturePath, bool realtime);
+};
+
+
+// Plays nothing & loads no sounds, so that
+// audio costs nothing
+class NullAudioDriver : public AudioDriver {
+
+public:
+
+    inline bool open() { return true; }
+    inline void close() {}
+    inline const char* getName() { return "null"; }
+};
+
+#endif // __AUDIO_DRIVER_H__
@@ -3,16 +3,16 @@
 
 #include "AudioManager.hpp"
 
-#define SDL_MAIN_HANDLED
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
+#include "Trace.hpp"
 
 #include <cstdio>
+#include <algorithm>
 
 
 // Constructor
-AudioManager::AudioManager() {
+AudioManager::AudioManager(AudioDriver* driver) {
+
+    TraceScope trace("AudioManager::AudioManager");
 
     // Set defaults
     sfxEnabled = true;
@@ -21,33 +21,78 @@ AudioManager::AudioManager() {
     musicVolume = 1.0f;
     currentTrack = NULL;
     currentVol = 1.0f;
-
-    // Initialize SDL2
-    initialized = 0;
-    if(SDL_Init(SDL_INIT_AUDIO) == -1) {
-        
-        printf("Failed to initialize SDL2. Audio disabled.\n");
-        return;
+    lastId = 0;
+    coalesced = 0;
+    stolen = 0;
+    dropped = 0;
+    overflows = 0;
+    for(int i = 0; i < AUDIO_VOICES; ++ i) {
+
+        voices[i].sample = NULL;
+        voices[i].id = 0;
+        voices[i].priority = 0;
+        voices[i].start = 0.0;
+        voices[i].volume = 0.0f;
     }
-    initialized = 2;
 
-    // Open audio
-    if(Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 512) == -1) {
+    // Open the output
+    if(!driver->open()) {
 
-        initialized = 0;
-        printf("Failed to open audio. Audio disabled.\n");
-        printf("Mix_OpenAudio: %s\n", Mix_GetError());
-        return;
+        printf("Warning: failed to open the %s audio driver. "
+            "Audio disabled.\n", driver->getName());
+        delete driver;
+        driver = new NullAudioDriver();
+        driver->open();
     }
+    this->driver = driver;
+    mixer = driver->getMixer();
+    mixTime = 0;
+    gameTime = 0.0;
+}
+
+
+// Destructor
+AudioManager::~AudioManager() {
+
+    // The sounds can be freed after this
+    driver->close();
+    delete driver;
+}
+
 
-    // Initialize Mixer
-    int flags = MIX_INIT_OGG;
-    int ret =  Mix_Init(flags);
-    if((ret & flags) != flags) {
+// Advance by game time
+void AudioManager::update(float ms) {
 
-        initialized = 1;
-        printf("Failed to initialize OGG addon. Music possibly disabled.\n");
-        printf("SDL_Mixer: %s\n", Mix_GetError());
+    driver->advance(ms);
+    gameTime += ms;
+
+    if(mixer == NULL) return;
+
+    int64 t = mixer->getMixTime();
+    Trace::counter("Audio mixing (us)", (t - mixTime) / 1000.0);
+    mixTime = t;
+}
+
+
+// Send a command to the mixer
+void AudioManager::send(int type, int voice, uint32 id, 
+    const int16* data, int size, float vol, int loops, int fade) {
+
+    AudioCommand c;
+    c.type = type;
+    c.voice = voice;
+    c.id = id;
+    c.data = data;
+    c.length = size / (sizeof(int16) * mixer->getChannels());
+    c.volume = std::min(vol, 1.0f);
+    c.loops = loops;
+    c.fade = fade;
+
+    // Never wait for the mixer
+    if(!mixer->push(c)) {
+
+        ++ overflows;
+        Trace::counter("Audio overflows", overflows);
     }
 }
 
@@ -55,17 +100,20 @@ AudioManager::AudioManager() {
 // Toggle music
 void AudioManager::toggleMusic(bool state) {
 
+    TraceScope trace("AudioManager::toggleMusic");
+
     musicEnabled = state;
     if(!state) {
 
-        Mix_HaltMusic();
+        if(mixer != NULL)
+            send(AudioCommandType::Stop, MUSIC_VOICE, 0);
     }
     else {
 
         if(currentTrack != NULL) {
 
             // Replay music
-            playMusic(currentTrack, currentVol);
+            startMusic(currentTrack, currentVol, 0, true);
         }
     }
 }
@@ -76,25 +124,156 @@ void AudioManager::toggleMusic() {
 
 
 
+// Is a voice playing
+bool AudioManager::isPlaying(int i) {
+
+    if(voices[i].sample == NULL)
+        return false;
+
+    // The mixer tells which sound finished last
+    if(mixer->getFinished(i) == voices[i].id) {
+
+        voices[i].sample = NULL;
+        return false;
+    }
+    return true;
+}
+
+
+// Find a voice for a sample
+int AudioManager::findVoice(int priority) {
+
+    int best = -1;
+    for(int i = 0; i < AUDIO_VOICES; ++ i) {
+
+        if(!isPlaying(i))
+            return i;
+
+        if(best == -1 || 
+           voices[i].priority < voices[best].priority ||
+           (voices[i].priority == voices[best].priority &&
+            voices[i].start < voices[best].start)) {
+
+            best = i;
+        }
+    }
+
+    if(voices[best].priority > priority)
+        return -1;
+
+    return best;
+}
+
+
+// Start a sample on a voice
+void AudioManager::startVoice(int i, Sample* s, float vol, int loops) {
+
+    voices[i].sample = s;
+    voices[i].priority = s->getPriority();
+    voices[i].start = gameTime;
+    voices[i].volume = vol;
+
+    // Ids wrap around, but 0 is never used
+    if(++ lastId == 0)
+        ++ lastId;
+    voices[i].id = lastId;
+
+    send(AudioCommandType::Play, i, lastId, s->getData(), s->getSize(),
+        vol, loops);
+}
+
+
 // Play a sample
 void AudioManager::playSample(Sample* s, float vol, int loops) {
 
-    if(s == NULL || initialized == 0 || !sfxEnabled) 
+    TraceScope trace("AudioManager::playSample");
+
+    if(s == NULL || mixer == NULL || !sfxEnabled || !s->isLoaded()) 
+        return;
+
+    vol *= sfxVolume;
+
+    // Already playing
+    int i;
+    for(i = 0; i < AUDIO_VOICES; ++ i) {
+
+        if(voices[i].sample == s && isPlaying(i))
+            break;
+    }
+    if(i < AUDIO_VOICES) {
+
+        // Merge a trigger that comes right after the
+        // previous one, keeping the louder volume
+        if(gameTime - voices[i].start < AUDIO_COALESCE_TIME) {
+
+            if(vol > voices[i].volume) {
+
+                voices[i].volume = vol;
+                send(AudioCommandType::Volume, i, voices[i].id, 
+                    NULL, 0, vol);
+            }
+            ++ coalesced;
+            Trace::counter("Audio coalesced", coalesced);
+            return;
+        }
+
+        startVoice(i, s, vol, loops);
+        return;
+    }
+
+    i = findVoice(s->getPriority());
+    if(i < 0) {
+
+        ++ dropped;
+        Trace::counter("Audio dropped", dropped);
         return;
+    }
+    if(voices[i].sample != NULL) {
+
+        ++ stolen;
+        Trace::counter("Audio stolen", stolen);
+    }
+    startVoice(i, s, vol, loops);
+}
+
+
+// Stop a sample
+void AudioManager::stopSample(Sample* s) {
+
+    if(mixer == NULL) return;
+
+    for(int i = 0; i < AUDIO_VOICES; ++ i) {
+
+        if(voices[i].sample == s) {
+
+            send(AudioCommandType::Stop, i, voices[i].id);
+            voices[i].sample = NULL;
+        }
+    }
+}
+
+
+// Start music
+void AudioManager::startMusic(Music* m, float vol, int fade, bool loop) {
 
-    s->play(vol*sfxVolume, loops);
+    if(mixer == NULL || !m->isLoaded()) return;
+
+    send(AudioCommandType::Play, MUSIC_VOICE, 1, m->getData(), m->getSize(),
+        vol, loop ? -1 : 0, fade);
 }
 
 
 // Play music
 void AudioManager::playMusic(Music* m, float vol, bool loop) {
 
+    TraceScope trace("AudioManager::playMusic");
+
     currentTrack = m;
     currentVol = musicVolume * vol;
 
     if(!musicEnabled) return;
 
-    m->play(currentVol, loop);
+    startMusic(m, currentVol, 0, loop);
 }
 
 
@@ -102,12 +281,14 @@ void AudioManager::playMusic(Music* m, float vol, bool loop) {
 // Fade in music
 void AudioManager::fadeInMusic(Music* m, float vol, int time, bool loop) {
 
+    TraceScope trace("AudioManager::fadeInMusic");
+
     currentTrack = m;
     currentVol = musicVolume * vol;
 
     if(!musicEnabled) return;
 
-    m->fadeIn(currentVol, time, loop);
+    startMusic(m, currentVol, time, loop);
 }
 
 
@@ -115,12 +296,14 @@ void AudioManager::fadeInMusic(Music* m, float vol, int time, bool loop) {
 // Fade out music
 void AudioManager::fadeOutMusic(int time) {
 
+    TraceScope trace("AudioManager::fadeOutMusic");
+
     currentTrack = NULL;
     currentVol = 0.0f;
 
-    if(!musicEnabled) return;
+    if(!musicEnabled || mixer == NULL) return;
 
-    Mix_FadeOutMusic(time);
+    send(AudioCommandType::FadeOut, MUSIC_VOICE, 0, NULL, 0, 0.0f, 0, time);
 }
 
 
@@ -128,10 +311,12 @@ void AudioManager::fadeOutMusic(int time) {
 // Stop music
 void AudioManager::stopMusic() {
 
+    TraceScope trace("AudioManager::stopMusic");
+
     currentTrack = NULL;
     currentVol = 0.0f;
 
-    if(!musicEnabled) return;
+    if(!musicEnabled || mixer == NULL) return;
 
-    Mix_HaltMusic();
+    send(AudioCommandType::Stop, MUSIC_VOICE, 0);
 }
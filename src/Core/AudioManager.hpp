@@ -6,8 +6,32 @@
 
 #include "Sample.hpp"
 #include "Music.hpp"
+#include "AudioDriver.hpp"
 
-// A audio manager class
+// Triggers of a sample closer than this to its
+// latest start are merged into it, in milliseconds
+#define AUDIO_COALESCE_TIME 50
+
+
+// A mixer voice used for samples
+struct Voice {
+
+    // The sample started last, NULL if none
+    Sample* sample;
+    // Id of the sound started
+    uint32 id;
+    // Its priority
+    int priority;
+    // Start time in game time, milliseconds
+    double start;
+    // Volume it was started with
+    float volume;
+};
+
+// A audio manager class. Sounds are mixed by the mixer
+// of the driver, which is only sent commands, so nothing
+// here waits for the mixing. Call from one thread at
+// a time
 class AudioManager {
 
 private:
@@ -15,10 +39,6 @@ private:
     // States
     bool sfxEnabled;
     bool musicEnabled;
-    // If successfully initialized
-    // (1 = sfx only)
-    // (2 = music & sfx)
-    int initialized;
 
     // Global volumes
     float sfxVolume;
@@ -29,10 +49,52 @@ private:
     // Current volume
     float currentVol;
 
+    // Output
+    AudioDriver* driver;
+    // Mixer of the driver, NULL if audio is disabled
+    AudioMixer* mixer;
+    // Mixing time at the latest update
+    int64 mixTime;
+    // Game time passed, in milliseconds. Sounds are
+    // timed by it, so that they do not depend on
+    // how fast the game runs
+    double gameTime;
+    // Id of the latest sound
+    uint32 lastId;
+
+    // Voices, as the mixer has them
+    Voice voices[AUDIO_VOICES];
+    // Triggers merged, voices cut & triggers
+    // dropped for having no voice
+    int coalesced;
+    int stolen;
+    int dropped;
+    // Commands lost for a full queue
+    int overflows;
+
+    // Send a command to the mixer
+    void send(int type, int voice, uint32 id, const int16* data = NULL,
+        int size = 0, float vol = 0.0f, int loops = 0, int fade = 0);
+    // Start music
+    void startMusic(Music* m, float vol, int fade, bool loop);
+
+    // Is a voice playing
+    bool isPlaying(int i);
+    // Find a voice for a sample of the given priority.
+    // A free one if any, otherwise the one of the lowest
+    // priority that started first, if not higher than
+    // the given one. Returns -1 if none
+    int findVoice(int priority);
+    // Start a sample on a voice
+    void startVoice(int i, Sample* s, float vol, int loops);
+
 public:
 
-    // Constructor
-    AudioManager();
+    // Constructor, the driver is taken. If it cannot be
+    // opened, the null driver is used instead
+    AudioManager(AudioDriver* driver);
+    // Destructor
+    ~AudioManager();
 
     // Toggle states
     inline void toggleSfx(bool state) {
@@ -57,9 +119,21 @@ public:
     inline bool isMusicEnabled() {
         return musicEnabled;
     }
+    inline int getCoalesced() { return coalesced; }
+    inline int getStolen() { return stolen; }
+    inline int getDropped() { return dropped; }
+    inline int getOverflows() { return overflows; }
+    inline const char* getDriverName() { return driver->getName(); }
+
+    // Advance by game time, in milliseconds. Call
+    // after each logic step
+    void update(float ms);
 
-    // Play a sample
+    // Play a sample. A sample has at most one voice,
+    // playing it again restarts it
     void playSample(Sample* s, float vol, int loops=0);
+    // Stop a sample
+    void stopSample(Sample* s);
     // Play music
     void playMusic(Music* m, float vol, bool loop=true);
     // Fade in music
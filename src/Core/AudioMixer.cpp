@@ -0,0 +1,202 @@
+// Audio mixer
+// (c) 2019 Jani Nykänen
+
+#include "AudioMixer.hpp"
+
+#include "Utility.hpp"
+
+#include <algorithm>
+
+
+// Constructor
+AudioMixer::AudioMixer(int frequency, int channels) {
+
+    this->frequency = frequency;
+    this->channels = channels;
+    mixTime = 0;
+
+    for(int i = 0; i <= AUDIO_VOICES; ++ i) {
+
+        voices[i].data = NULL;
+        voices[i].id = 0;
+        finished[i] = 0;
+    }
+
+    // Enough for the usual callback, grown
+    // if a longer one comes
+    buffer.resize(4096 * channels);
+}
+
+
+// Stop a voice
+void AudioMixer::stopVoice(int i) {
+
+    if(voices[i].data == NULL) return;
+
+    voices[i].data = NULL;
+    finished[i].store(voices[i].id);
+}
+
+
+// Run a command
+void AudioMixer::execute(const AudioCommand &c) {
+
+    if(c.voice < 0 || c.voice > AUDIO_VOICES)
+        return;
+
+    MixVoice &v = voices[c.voice];
+    switch(c.type) {
+
+    case AudioCommandType::Play:
+        // The sound replaced is done
+        stopVoice(c.voice);
+
+        v.data = c.data;
+        v.length = c.length;
+        v.pos = 0;
+        v.loops = c.loops;
+        v.id = c.id;
+        v.fadeOut = false;
+        // Fade in
+        if(c.fade > 0) {
+
+            v.volume = 0.0f;
+            v.target = c.volume;
+            v.step = c.volume / (c.fade * frequency / 1000.0f);
+        }
+        else {
+
+            v.volume = c.volume;
+            v.step = 0.0f;
+        }
+        if(v.data == NULL || v.length <= 0)
+            stopVoice(c.voice);
+        break;
+
+    case AudioCommandType::Stop:
+        stopVoice(c.voice);
+        break;
+
+    case AudioCommandType::Volume:
+        if(v.id == c.id && v.step == 0.0f)
+            v.volume = c.volume;
+        break;
+
+    case AudioCommandType::FadeOut:
+        if(c.fade <= 0 || v.volume <= 0.0f) {
+
+            stopVoice(c.voice);
+            break;
+        }
+        v.target = 0.0f;
+        v.step = -v.volume / (c.fade * frequency / 1000.0f);
+        v.fadeOut = true;
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+// Add a voice to the buffer
+void AudioMixer::mixVoice(int i, int frames) {
+
+    MixVoice &v = voices[i];
+    int32* out = &buffer[0];
+    const int16* in;
+    int n, gain;
+
+    int f = 0;
+    while(f < frames && v.data != NULL) {
+
+        // Loop or stop at the end
+        if(v.pos >= v.length) {
+
+            if(v.loops == 0) {
+
+                stopVoice(i);
+                break;
+            }
+            if(v.loops > 0)
+                -- v.loops;
+            v.pos = 0;
+        }
+
+        n = std::min(frames - f, v.length - v.pos);
+        in = &v.data[v.pos * channels];
+
+        // Fixed volume, in 1/256ths
+        if(v.step == 0.0f) {
+
+            gain = (int)(v.volume * 256.0f);
+            for(int j = 0; j < n * channels; ++ j) {
+
+                out[j] += (in[j] * gain) >> 8;
+            }
+        }
+        // Fading, the volume changes per frame
+        else {
+
+            for(int k = 0; k < n; ++ k) {
+
+                for(int c = 0; c < channels; ++ c) {
+
+                    out[k*channels + c] += (int32)(in[k*channels + c] * v.volume);
+                }
+
+                v.volume += v.step;
+                if((v.step > 0.0f && v.volume >= v.target) ||
+                   (v.step < 0.0f && v.volume <= v.target)) {
+
+                    v.volume = v.target;
+                    v.step = 0.0f;
+                    n = k + 1;
+                    break;
+                }
+            }
+            if(v.step == 0.0f && v.fadeOut) {
+
+                stopVoice(i);
+                break;
+            }
+        }
+
+        v.pos += n;
+        out += n * channels;
+        f += n;
+    }
+}
+
+
+// Mix
+void AudioMixer::mix(int16* out, int frames) {
+
+    int64 start = getNanoTime();
+
+    AudioCommand c;
+    while(queue.pop(c)) {
+
+        execute(c);
+    }
+
+    int count = frames * channels;
+    if(buffer.size() < count)
+        buffer.resize(count);
+    std::fill(buffer.begin(), buffer.begin() + count, 0);
+
+    for(int i = 0; i <= AUDIO_VOICES; ++ i) {
+
+        mixVoice(i, frames);
+    }
+
+    // Add to what is there, clipped
+    int32 s;
+    for(int i = 0; i < count; ++ i) {
+
+        s = out[i] + buffer[i];
+        out[i] = (int16)std::max(-32768, std::min(32767, s));
+    }
+
+    mixTime += getNanoTime() - start;
+}
@@ -0,0 +1,124 @@
+// Audio mixer
+// (c) 2019 Jani Nykänen
+
+#ifndef __AUDIO_MIXER_H__
+#define __AUDIO_MIXER_H__
+
+#include "Types.hpp"
+#include "RingBuffer.hpp"
+
+#include <atomic>
+#include <vector>
+
+// Samples played at the same time
+#define AUDIO_VOICES 8
+// The voice after the sample voices is for music
+#define MUSIC_VOICE AUDIO_VOICES
+// Commands that can wait for the mixer
+#define AUDIO_QUEUE_SIZE 256
+
+// Command types
+namespace AudioCommandType {
+
+    enum {
+        // Start a sound on a voice
+        Play = 0,
+        // Stop a voice
+        Stop = 1,
+        // Set the volume of a voice, if it still
+        // plays the sound with the id given
+        Volume = 2,
+        // Fade a voice out & stop it
+        FadeOut = 3,
+    };
+}
+
+
+// A command from the game thread to the mixer
+struct AudioCommand {
+
+    int type;
+    int voice;
+    // Id of the sound, never 0
+    uint32 id;
+    // 16-bit PCM in the mixer format
+    const int16* data;
+    // Length in frames
+    int length;
+    float volume;
+    // Times to repeat, -1 forever
+    int loops;
+    // Fade time in milliseconds
+    int fade;
+};
+
+
+// A voice being mixed
+struct MixVoice {
+
+    // NULL if not playing
+    const int16* data;
+    int length;
+    int pos;
+    int loops;
+    uint32 id;
+    float volume;
+    // Volume change per frame & where it stops
+    float step;
+    float target;
+    // Stop once the target is reached
+    bool fadeOut;
+};
+
+
+// Mixes 16-bit PCM that is already in the output
+// format. Sounds are started & stopped by pushing
+// commands from the game thread, and mixed on the
+// audio thread, so that neither waits for the other
+class AudioMixer {
+
+private:
+
+    // Commands waiting
+    RingBuffer<AudioCommand, AUDIO_QUEUE_SIZE> queue;
+    // Voices, read & written on the audio thread only
+    MixVoice voices[AUDIO_VOICES + 1];
+    // Id of the sound that finished last on each voice
+    std::atomic<uint32> finished[AUDIO_VOICES + 1];
+
+    // Output format
+    int frequency;
+    int channels;
+    // Sum of the voices
+    std::vector<int32> buffer;
+    // Time spent mixing, in nanoseconds
+    std::atomic<int64> mixTime;
+
+    // Run a command
+    void execute(const AudioCommand &c);
+    // Stop a voice
+    void stopVoice(int i);
+    // Add a voice to the buffer
+    void mixVoice(int i, int frames);
+
+public:
+
+    // Constructor
+    AudioMixer(int frequency, int channels);
+
+    // Push a command. Returns false if the queue is
+    // full. Game thread only
+    inline bool push(const AudioCommand &c) { return queue.push(c); }
+
+    // Run the commands waiting & add the voices to the
+    // output. Mixing thread only
+    void mix(int16* out, int frames);
+
+    // Getters
+    inline int getFrequency() { return frequency; }
+    inline int getChannels() { return channels; }
+    inline uint32 getFinished(int voice) { return finished[voice].load(); }
+    inline int64 getMixTime() { return mixTime.load(); }
+};
+
+#endif // __AUDIO_MIXER_H__
@@ -4,32 +4,170 @@
 #include "Bitmap.hpp"
 
 #include <cstdio>
+#include <cstdlib>
 #include <algorithm>
 #include <iterator>
 #include <stdexcept>
 
+#include <GL/glew.h>
 #include <GL/gl.h>
 
+#include "GLState.hpp"
+#include "TextureBudget.hpp"
+#include "Trace.hpp"
+
 #include "../Lib/ReadPNG.hpp"
 
-// Previous texture
-static Bitmap* prevTex = NULL;
+
+// GL parameters of a format
+struct GLFormat {
+
+    int internal;
+    int format;
+    int type;
+};
+
+
+// Get the GL parameters of a format
+static GLFormat getGLFormat(int format) {
+
+    GLFormat f;
+    f.format = GL_RGBA;
+    switch(format) {
+
+    case BitmapFormat::RGBA4444:
+        f.internal = GL_RGBA4;
+        f.type = GL_UNSIGNED_SHORT_4_4_4_4;
+        break;
+
+    case BitmapFormat::RGBA5551:
+        f.internal = GL_RGB5_A1;
+        f.type = GL_UNSIGNED_SHORT_5_5_5_1;
+        break;
+
+    case BitmapFormat::GrayAlpha:
+        f.internal = GL_LUMINANCE8_ALPHA8;
+        f.format = GL_LUMINANCE_ALPHA;
+        f.type = GL_UNSIGNED_BYTE;
+        break;
+
+    default:
+        f.internal = GL_RGBA;
+        f.type = GL_UNSIGNED_BYTE;
+        break;
+    }
+    return f;
+}
+
+
+// Reduce a channel to the given bits
+static inline uint16 quantize(uint8 v, int bits) {
+
+    return (uint16) ((v * ((1 << bits) - 1) + 127) / 255);
+}
+
+
+// Convert RGBA8 data to a format. Returns the data
+// itself for RGBA8, a buffer from malloc otherwise
+static const uint8* convert(const uint8* data, int w, int h, int format) {
+
+    if(data == NULL || format == BitmapFormat::RGBA8)
+        return data;
+
+    uint8* out = (uint8*)malloc(w*h*2);
+    uint16* packed = (uint16*)out;
+    const uint8* p;
+    for(int i = 0; i < w*h; ++ i) {
+
+        p = &data[i*4];
+        switch(format) {
+
+        case BitmapFormat::RGBA4444:
+            packed[i] = (quantize(p[0], 4) << 12) | (quantize(p[1], 4) << 8) |
+                (quantize(p[2], 4) << 4) | quantize(p[3], 4);
+            break;
+
+        case BitmapFormat::RGBA5551:
+            packed[i] = (quantize(p[0], 5) << 11) | (quantize(p[1], 5) << 6) |
+                (quantize(p[2], 5) << 1) | (p[3] >= 128 ? 1 : 0);
+            break;
+
+        default:
+            out[i*2] = p[0];
+            out[i*2 +1] = p[3];
+            break;
+        }
+    }
+    return out;
+}
+
+
+// Number of mipmap levels of a size
+static int getLevelCount(int w, int h) {
+
+    int levels = 1;
+    while((w >> levels) > 0 || (h >> levels) > 0)
+        ++ levels;
+
+    return levels;
+}
 
 
 // Create
-void Bitmap::create(int width, int height, uint8* src) {
+void Bitmap::create(int width, int height, const uint8* data,
+    int format, bool mipmap) {
 
     // Store dimensions
     this->width = width;
     this->height = height;
+    texX = 0;
+    texY = 0;
+    texWidth = width;
+    texHeight = height;
+    owner = this;
+
+    // Storage
+    this->format = format;
+    this->mipmap = mipmap;
+    resident = false;
+    lastUse = TextureBudget::getFrame();
+    sourceData = NULL;
 
     // Create texture
     glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GLState::bindTexture(texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+        mipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
-	    GL_UNSIGNED_BYTE, src);
+    uploadTexture(data);
+
+    TextureBudget::add(this);
+}
+
+
+// Upload the whole content
+void Bitmap::uploadTexture(const uint8* data) {
+
+    GLFormat f = getGLFormat(format);
+    const uint8* pixels = convert(data, width, height, format);
+
+    GLState::bindTexture(texture);
+    // The levels are made whenever the
+    // content changes
+    if(mipmap) {
+
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+    }
+    // The 16-bit formats have rows of any even length
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, f.internal, width, height, 0, f.format,
+	    f.type, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if(pixels != data)
+        free((void*)pixels);
+
+    resident = true;
 }
 
 
@@ -46,37 +184,230 @@ Bitmap::Bitmap(int width, int height) {
     }
 
     // Create
-    create(width, height, data);
+    create(width, height, data, BitmapFormat::RGBA8, false);
 
     // Clear data
     delete[] data;
 }
-Bitmap::Bitmap(int width, int height, uint8* data) {
-    
+Bitmap::Bitmap(int width, int height, const uint8* data,
+    int format, bool mipmap) {
+
     // Create
-    create(width, height, data);
+    create(width, height, data, format, mipmap);
 }
-Bitmap::Bitmap(std::string path) {
+Bitmap::Bitmap(std::string path, int format, bool mipmap) {
 
     uint8* data = readPNG(path, width, height);
-    create(width, height, data);
+    create(width, height, data, format, mipmap);
     free(data);
+
+    sourcePath = path;
+}
+Bitmap::Bitmap(Bitmap* parent, int x, int y, int width, int height) {
+
+    this->width = width;
+    this->height = height;
+    owner = parent->owner;
+    texture = 0;
+
+    texX = parent->texX + x;
+    texY = parent->texY + y;
+    texWidth = parent->texWidth;
+    texHeight = parent->texHeight;
+
+    // The storage is the owner's
+    format = owner->format;
+    mipmap = false;
+    resident = false;
+    lastUse = 0;
+    sourceData = NULL;
 }
 
 
 // Destructor
 Bitmap::~Bitmap() {
 
-    // ...
+    if(owner == this) {
+
+        TextureBudget::remove(this);
+        GLState::deleteTexture(texture);
+    }
 }
 
 
 // Bind
 void Bitmap::bind() {
 
-    if(prevTex != this) {
+    if(!owner->resident)
+        owner->restore();
+
+    owner->lastUse = TextureBudget::getFrame();
+    GLState::bindTexture(owner->texture);
+}
+
+
+// Replace a part of the content
+void Bitmap::upload(const uint8* data, int x, int y, int w, int h) {
+
+    // An evicted texture is read from
+    // the source when needed
+    if(!owner->resident) return;
 
-        prevTex = this;
-        glBindTexture(GL_TEXTURE_2D, texture);
+    // Clip to the texture
+    int sx = std::max(0, -(texX + x));
+    int sy = std::max(0, -(texY + y));
+    int dx = texX + x + sx;
+    int dy = texY + y + sy;
+    int cw = std::min(w - sx, texWidth - dx);
+    int ch = std::min(h - sy, texHeight - dy);
+    if(cw <= 0 || ch <= 0) return;
+
+    GLFormat f = getGLFormat(owner->format);
+    const uint8* pixels = convert(data, w, h, owner->format);
+
+    GLState::bindTexture(owner->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, w);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, sx);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, sy);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dx, dy, cw, ch, f.format,
+        f.type, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    if(pixels != data)
+        free((void*)pixels);
+}
+
+
+// Replace the whole content
+void Bitmap::replace(const uint8* data, int width, int height) {
+
+    if(width == this->width && height == this->height) {
+
+        upload(data, 0, 0, width, height);
+        return;
     }
+
+    // The texture must be reallocated
+    this->width = width;
+    this->height = height;
+    texWidth = width;
+    texHeight = height;
+
+    if(resident)
+        uploadTexture(data);
+}
+
+
+// Set where the content can be read again
+void Bitmap::setSource(const uint8* data) {
+
+    sourceData = data;
+}
+void Bitmap::setSource(std::string path) {
+
+    sourcePath = path;
+}
+
+
+// Free the GPU memory
+bool Bitmap::evict() {
+
+    if(owner != this || !resident || !canEvict())
+        return false;
+
+    TraceScope trace("Bitmap::evict");
+
+    // The texture object is kept, so that the regions
+    // and the batches can still refer to it. Every
+    // level is emptied to free the memory
+    GLFormat f = getGLFormat(format);
+    GLState::bindTexture(texture);
+    int levels = 1;
+    if(mipmap) {
+
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
+        levels = getLevelCount(width, height);
+    }
+    for(int i = 0; i < levels; ++ i) {
+
+        glTexImage2D(GL_TEXTURE_2D, i, f.internal, 0, 0, 0, f.format,
+            f.type, NULL);
+    }
+    resident = false;
+
+    return true;
+}
+
+
+// Upload the content again
+void Bitmap::restore() {
+
+    TraceScope trace("Bitmap::restore");
+
+    if(sourceData != NULL) {
+
+        uploadTexture(sourceData);
+        return;
+    }
+
+    // The file may have changed meanwhile
+    uint8* data = NULL;
+    int w, h;
+    try {
+
+        data = readPNG(sourcePath, w, h);
+    }
+    catch(std::runtime_error err) {
+
+        // Stays evicted, and is tried again
+        // the next time it is bound
+        printf("Warning: could not restore a texture: %s\n", err.what());
+        return;
+    }
+    width = w;
+    height = h;
+    texWidth = w;
+    texHeight = h;
+
+    uploadTexture(data);
+    free(data);
+}
+
+
+// Get a format by its name
+int Bitmap::parseFormat(std::string name) {
+
+    if(name == "rgba8")
+        return BitmapFormat::RGBA8;
+    else if(name == "rgba4444")
+        return BitmapFormat::RGBA4444;
+    else if(name == "rgba5551")
+        return BitmapFormat::RGBA5551;
+    else if(name == "gray_alpha")
+        return BitmapFormat::GrayAlpha;
+
+    throw std::runtime_error("Unknown bitmap format " + name);
+}
+
+
+// Bytes per pixel of a format
+int Bitmap::getPixelSize(int format) {
+
+    return format == BitmapFormat::RGBA8 ? 4 : 2;
+}
+
+
+// GPU memory of the texture
+int Bitmap::getByteSize() {
+
+    if(owner != this || !resident)
+        return 0;
+
+    int size = width * height * getPixelSize(format);
+    // The levels take a third more
+    return mipmap ? size + size/3 : size;
 }
@@ -8,6 +8,23 @@
 
 #include <string>
 
+// Texture formats. The data given is always
+// RGBA8, it is converted when uploaded
+namespace BitmapFormat {
+
+    enum {
+        // 32 bits per pixel
+        RGBA8 = 0,
+        // 16 bits per pixel
+        RGBA4444 = 1,
+        RGBA5551 = 2,
+        // Gray & alpha, 16 bits per pixel. The
+        // red channel is used as the gray
+        GrayAlpha = 3,
+    };
+}
+
+
 // Bitmap class
 class Bitmap {
 
@@ -16,28 +33,99 @@ private:
     // Dimensions
     int width;
     int height;
-    // Texture
+    // Texture, only of the owner
     uint32 texture;
+    // Position & size in the texture. Differ from
+    // the defaults only for atlas regions
+    int texX;
+    int texY;
+    int texWidth;
+    int texHeight;
+    // The bitmap the texture belongs to, this
+    // one if not a region
+    Bitmap* owner;
+
+    // Storage, of the owner
+    int format;
+    bool mipmap;
+    // Is the texture in GPU memory
+    bool resident;
+    // Frame the texture was last bound
+    int lastUse;
+    // Where the content can be read again, if
+    // the texture is evicted
+    const uint8* sourceData;
+    std::string sourcePath;
 
     // Create
-    void create(int width, int height, uint8* data);
+    void create(int width, int height, const uint8* data,
+        int format, bool mipmap);
+    // Upload the whole content, allocating
+    // the texture storage
+    void uploadTexture(const uint8* data);
 
 public:
 
     // Constructors
     Bitmap(int width, int height);
-    Bitmap(int width, int height, uint8* data);
-    Bitmap(std::string path);
+    Bitmap(int width, int height, const uint8* data,
+        int format = BitmapFormat::RGBA8, bool mipmap = false);
+    Bitmap(std::string path,
+        int format = BitmapFormat::RGBA8, bool mipmap = false);
+    // Create a region of another bitmap. The
+    // texture is shared
+    Bitmap(Bitmap* parent, int x, int y, int width, int height);
     // Destructor
     ~Bitmap();
 
-    // Bind
+    // Bind. Uploads the texture again if
+    // it has been evicted
     void bind();
 
+    // Replace a part of the content with RGBA data.
+    // The position is relative to the bitmap and may
+    // be outside it, the part outside the texture is
+    // left out
+    void upload(const uint8* data, int x, int y, int w, int h);
+    // Replace the whole content, the size may change.
+    // Not for regions
+    void replace(const uint8* data, int width, int height);
+
+    // Set where the content can be read again, so that
+    // the texture can be evicted. The data must stay
+    // valid as long as the bitmap exists
+    void setSource(const uint8* data);
+    void setSource(std::string path);
+    // Free the GPU memory, if the content can be read
+    // again. Returns false if it cannot
+    bool evict();
+    // Upload the content again
+    void restore();
+
+    // Get a format by its name in the asset config.
+    // Throws if unknown
+    static int parseFormat(std::string name);
+    // Bytes per pixel of a format
+    static int getPixelSize(int format);
+
     // Getters
     inline int getWidth() { return width; }
     inline int getHeight() { return height; }
-    inline uint32 getTexture() { return texture; }
+    inline uint32 getTexture() { return owner->texture; }
+    inline bool isRegion() { return owner != this; }
+    inline int getFormat() { return owner->format; }
+    inline bool isResident() { return owner->resident; }
+    inline int getLastUse() { return owner->lastUse; }
+    inline bool canEvict() {
+        return owner->sourceData != NULL || !owner->sourcePath.empty();
+    }
+    // GPU memory of the texture, 0 for regions
+    int getByteSize();
+
+    // Convert a position in the bitmap to
+    // texture coordinates
+    inline float getU(float x) { return (texX + x) / texWidth; }
+    inline float getV(float y) { return (texY + y) / texHeight; }
 };
 
 #endif // __BITMAP_H__
@@ -0,0 +1,160 @@
+// Capture audio driver
+// (c) 2019 Jani Nykänen
+
+#include "CaptureAudioDriver.hpp"
+
+#include "Trace.hpp"
+#include "Utility.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <chrono>
+#include <algorithm>
+
+// Size of the WAV header
+static const int WAV_HEADER_SIZE = 44;
+
+
+// Write a little-endian integer
+static void writeInt(FILE* f, uint32 v, int bytes) {
+
+    for(int i = 0; i < bytes; ++ i) {
+
+        fputc((v >> (i*8)) & 0xFF, f);
+    }
+}
+
+
+// Write the WAV header for 16-bit PCM
+static void writeHeader(FILE* f, int frequency, int channels, 
+    uint32 dataSize) {
+
+    fwrite("RIFF", 1, 4, f);
+    writeInt(f, WAV_HEADER_SIZE - 8 + dataSize, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    writeInt(f, 16, 4);
+    // PCM
+    writeInt(f, 1, 2);
+    writeInt(f, channels, 2);
+    writeInt(f, frequency, 4);
+    // Bytes per second & per frame
+    writeInt(f, frequency * channels * 2, 4);
+    writeInt(f, channels * 2, 2);
+    writeInt(f, 16, 2);
+    fwrite("data", 1, 4, f);
+    writeInt(f, dataSize, 4);
+}
+
+
+// Constructor
+CaptureAudioDriver::CaptureAudioDriver(std::string path, bool realtime) {
+
+    this->path = path;
+    this->realtime = realtime;
+    file = NULL;
+    written = 0;
+    time = 0.0;
+    running = false;
+}
+
+
+// Mix & write frames
+void CaptureAudioDriver::write(int64 frames) {
+
+    int channels = mixer->getChannels();
+    int n;
+    while(frames > 0) {
+
+        n = (int)std::min(frames, (int64)AUDIO_CHUNK_SIZE);
+        std::fill(chunk.begin(), chunk.end(), 0);
+        mixer->mix(&chunk[0], n);
+        fwrite(&chunk[0], sizeof(int16), n * channels, file);
+
+        written += n;
+        frames -= n;
+    }
+}
+
+
+// Mix by the clock
+void CaptureAudioDriver::run() {
+
+    Trace::setThreadName("Audio capture");
+
+    int frequency = mixer->getFrequency();
+    int64 start = getNanoTime();
+    int64 due;
+    while(running) {
+
+        due = (getNanoTime() - start) * frequency / 1000000000;
+        if(due > written)
+            write(due - written);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(
+            AUDIO_CHUNK_SIZE * 1000 / frequency));
+    }
+}
+
+
+// Create the file
+bool CaptureAudioDriver::open() {
+
+    // SDL_mixer is only needed for decoding
+    // the sounds, so no device is used
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if(!openMixer())
+        return false;
+
+    file = fopen(path.c_str(), "wb");
+    if(file == NULL) {
+
+        printf("Failed to create a file in %s\n", path.c_str());
+        return false;
+    }
+    // The sizes are written when closed
+    writeHeader(file, mixer->getFrequency(), mixer->getChannels(), 0);
+
+    chunk.resize(AUDIO_CHUNK_SIZE * mixer->getChannels());
+    if(realtime) {
+
+        running = true;
+        thread = std::thread(&CaptureAudioDriver::run, this);
+    }
+    return true;
+}
+
+
+// Finish the file
+void CaptureAudioDriver::close() {
+
+    if(file == NULL) return;
+
+    if(realtime) {
+
+        running = false;
+        thread.join();
+    }
+
+    uint32 size = (uint32)(written * mixer->getChannels() * sizeof(int16));
+    fseek(file, 0, SEEK_SET);
+    writeHeader(file, mixer->getFrequency(), mixer->getChannels(), size);
+    fclose(file);
+    file = NULL;
+
+    double seconds = (double)written / mixer->getFrequency();
+    printf("Captured %.3f s of audio to %s, mixing took %.3f ms per second\n",
+        seconds, path.c_str(), 
+        seconds > 0.0 ? mixer->getMixTime() / 1000000.0 / seconds : 0.0);
+}
+
+
+// Mix the game time passed
+void CaptureAudioDriver::advance(double ms) {
+
+    if(file == NULL || realtime) return;
+
+    time += ms;
+    int64 due = (int64)(time * mixer->getFrequency() / 1000.0 + 0.5);
+    if(due > written)
+        write(due - written);
+}
@@ -0,0 +1,61 @@
+// Capture audio driver
+// (c) 2019 Jani Nykänen
+
+#ifndef __CAPTURE_AUDIO_DRIVER_H__
+#define __CAPTURE_AUDIO_DRIVER_H__
+
+#include "AudioDriver.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+
+// Writes the mix to a WAV file instead of playing it.
+// In real time it mixes on its own thread by the clock,
+// otherwise by the game time, as fast as the game runs,
+// so that the output does not depend on the speed
+class CaptureAudioDriver : public AudioDriver {
+
+private:
+
+    // Output
+    std::string path;
+    FILE* file;
+    // Mix by the clock
+    bool realtime;
+
+    // Frames written
+    int64 written;
+    // Game time passed, in milliseconds
+    double time;
+    // One chunk of the mix
+    std::vector<int16> chunk;
+
+    // Mixing thread, in real time
+    std::thread thread;
+    std::atomic<bool> running;
+
+    // Mix & write frames
+    void write(int64 frames);
+    // Mix by the clock until closed
+    void run();
+
+public:
+
+    // Constructor
+    CaptureAudioDriver(std::string path, bool realtime);
+
+    // Create the file
+    bool open();
+    // Finish the file
+    void close();
+    // Mix the game time passed, if not in real time
+    void advance(double ms);
+
+    // Getters
+    inline const char* getName() { return "capture"; }
+};
+
+#endif // __CAPTURE_AUDIO_DRIVER_H__
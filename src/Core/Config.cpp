@@ -141,6 +141,45 @@ ConfigData::ConfigData(std::string path) {
 }
 
 
+// Set parameter
+void ConfigData::setParam(std::string key, std::string value) {
+
+    for(int i = 0; i < params.size(); ++ i) {
+
+        if(params[i].key == key) {
+
+            params[i].value = value;
+            return;
+        }
+    }
+    params.push_back(KeyValuePair(key, value));
+}
+
+
+// Read parameters from the command line
+void ConfigData::parseArgs(int argc, char** argv) {
+
+    std::string arg;
+    size_t eq;
+    for(int i = 1; i < argc; ++ i) {
+
+        arg = std::string(argv[i]);
+        if(arg.length() < 3 || arg[0] != '-' || arg[1] != '-') {
+
+            std::cout << "Warning: unknown argument " << arg << "\n";
+            continue;
+        }
+        arg = arg.substr(2);
+
+        eq = arg.find('=');
+        if(eq == std::string::npos)
+            setParam(arg, "1");
+        else
+            setParam(arg.substr(0, eq), arg.substr(eq+1));
+    }
+}
+
+
 // Get parameter
 std::string ConfigData::getParam(std::string key, std::string def) {
 
@@ -24,6 +24,12 @@ public:
     ConfigData();
     ConfigData(std::string path);
 
+    // Set parameter, overriding an existing one
+    void setParam(std::string key, std::string value);
+    // Read parameters from the command line. Both
+    // "--key=value" and "--key" (value 1) work
+    void parseArgs(int argc, char** argv);
+
     // Get parameter
     std::string getParam(std::string key, std::string def);
     std::string getParam(std::string key);
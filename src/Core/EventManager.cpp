@@ -7,8 +7,8 @@
 
 
 // Constructor
-EventManager::EventManager(Application* ref, void* window, GamePad* vpad) 
-    : InputListener(window) {
+EventManager::EventManager(Application* ref, void* window, GamePad* vpad,
+    AudioDriver* audioDriver) : InputListener(window) {
 
     appRef = ref;
     this->vpad = vpad;
@@ -16,7 +16,7 @@ EventManager::EventManager(Application* ref, void* window, GamePad* vpad)
 
     // Create audio manager
     // (temporarily here)
-    audio = new AudioManager();
+    audio = new AudioManager(audioDriver);
 }
 
 
@@ -30,3 +30,4 @@ EventManager::~EventManager() {
 // Redirect to application core
 void EventManager::terminate() {appRef->terminate();}
 void EventManager::toggleFullscreen() {appRef->toggleFullscreen();}
+void EventManager::writeFrameStats() {appRef->writeFrameStats();}
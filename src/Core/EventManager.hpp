@@ -29,13 +29,16 @@ private:
 public:
 
     // Constructor
-    EventManager(Application* ref, void* window, GamePad* vpad);
+    // The audio driver is given to the audio manager
+    EventManager(Application* ref, void* window, GamePad* vpad,
+        AudioDriver* audioDriver);
     // Destructor
     ~EventManager();
 
     // Redirect to application core
     void terminate();
     void toggleFullscreen();
+    void writeFrameStats();
 
     // Get controller
     inline GamePad* getController() {
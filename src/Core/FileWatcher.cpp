@@ -0,0 +1,182 @@
+// File watcher
+// (c) 2019 Jani Nykänen
+
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+// Size of the event buffer
+static const int EVENT_BUFFER_SIZE = 4096;
+
+
+// Watch a single directory
+bool FileWatcher::addDirectory(std::string dir, bool recursive) {
+
+#ifdef __linux__
+    // Written files, and files moved in, since
+    // many editors save to a temporary file first
+    int wd = inotify_add_watch(fd, dir.empty() ? "." : dir.c_str(),
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if(wd < 0) return false;
+
+    WatchedDir w;
+    w.path = dir;
+    w.recursive = recursive;
+    dirs[wd] = w;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+// Add the files in a directory & its subdirectories
+void FileWatcher::findFiles(std::string dir, 
+    std::vector<std::string> &out) {
+
+#ifdef __linux__
+    DIR* d = opendir(dir.c_str());
+    if(d == NULL) return;
+
+    std::string path;
+    struct stat st;
+    struct dirent* e;
+    while((e = readdir(d)) != NULL) {
+
+        if(e->d_name[0] == '.') continue;
+
+        path = dir + std::string(e->d_name);
+        if(stat(path.c_str(), &st) != 0) continue;
+
+        if(S_ISDIR(st.st_mode)) {
+
+            findFiles(path + "/", out);
+        }
+        else if(std::find(out.begin(), out.end(), path) == out.end()) {
+
+            out.push_back(path);
+        }
+    }
+    closedir(d);
+#endif
+}
+
+
+// Constructor
+FileWatcher::FileWatcher() {
+
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+    fd = -1;
+#endif
+}
+
+
+// Destructor
+FileWatcher::~FileWatcher() {
+
+#ifdef __linux__
+    if(fd >= 0)
+        close(fd);
+#endif
+}
+
+
+// Watch a directory
+bool FileWatcher::watch(std::string dir, bool recursive) {
+
+    if(fd < 0) return false;
+
+    if(!dir.empty() && dir[dir.length()-1] != '/')
+        dir += "/";
+
+    if(!addDirectory(dir, recursive))
+        return false;
+    if(!recursive)
+        return true;
+
+#ifdef __linux__
+    // Subdirectories
+    DIR* d = opendir(dir.empty() ? "." : dir.c_str());
+    if(d == NULL) return true;
+
+    std::string name;
+    struct stat st;
+    struct dirent* e;
+    while((e = readdir(d)) != NULL) {
+
+        name = std::string(e->d_name);
+        if(name[0] == '.') continue;
+
+        if(stat((dir + name).c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+
+            watch(dir + name, true);
+        }
+    }
+    closedir(d);
+#endif
+
+    return true;
+}
+
+
+// Get the files changed since the last call
+void FileWatcher::poll(std::vector<std::string> &changed) {
+
+    if(fd < 0) return;
+
+#ifdef __linux__
+    // Aligned for the events
+    char buffer[EVENT_BUFFER_SIZE]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    std::string path;
+    const struct inotify_event* e;
+    ssize_t len;
+    while((len = read(fd, buffer, sizeof(buffer))) > 0) {
+
+        for(char* p = buffer; p < buffer + len;
+            p += sizeof(struct inotify_event) + e->len) {
+
+            e = (const struct inotify_event*)p;
+
+            auto it = dirs.find(e->wd);
+            if(it == dirs.end() || e->len == 0)
+                continue;
+            path = it->second.path + std::string(e->name);
+
+            // New directories are watched, too. Files
+            // written before that are reported now
+            if(e->mask & IN_ISDIR) {
+
+                if((e->mask & (IN_CREATE | IN_MOVED_TO)) &&
+                   it->second.recursive && watch(path, true)) {
+
+                    findFiles(path + "/", changed);
+                }
+                continue;
+            }
+            // A created file is reported once it
+            // has been written
+            if(e->mask & IN_CREATE)
+                continue;
+
+            if(std::find(changed.begin(), changed.end(), path)
+                == changed.end()) {
+
+                changed.push_back(path);
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,60 @@
+// File watcher
+// (c) 2019 Jani Nykänen
+
+#ifndef __FILE_WATCHER_H__
+#define __FILE_WATCHER_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// A watched directory
+struct WatchedDir {
+
+    // With a trailing slash, empty for the
+    // working directory
+    std::string path;
+    // Are new subdirectories watched, too
+    bool recursive;
+};
+
+
+// Watches directories for files written or moved
+// into them, with inotify. Does nothing on other
+// systems than Linux
+class FileWatcher {
+
+private:
+
+    // Inotify instance, -1 if not available
+    int fd;
+    // Watch descriptor to directory
+    std::unordered_map<int, WatchedDir> dirs;
+
+    // Watch a single directory
+    bool addDirectory(std::string dir, bool recursive);
+    // Add the files in a directory & its
+    // subdirectories to a list
+    void findFiles(std::string dir, std::vector<std::string> &out);
+
+public:
+
+    // Constructor
+    FileWatcher();
+    // Destructor
+    ~FileWatcher();
+
+    // Watch a directory, and its subdirectories if
+    // recursive. An empty path is the working
+    // directory. Returns false if it cannot be watched
+    bool watch(std::string dir, bool recursive = false);
+
+    // Get the files changed since the last call,
+    // without waiting. Each path is given once
+    void poll(std::vector<std::string> &changed);
+
+    // Getters
+    inline bool isEnabled() { return fd >= 0; }
+};
+
+#endif // __FILE_WATCHER_H__
@@ -0,0 +1,185 @@
+// Frame statistics
+// (c) 2019 Jani Nykänen
+
+#include "FrameStats.hpp"
+
+#include <cstring>
+
+
+// Get the bucket of a value
+int Histogram::getBucket(int64 v) {
+
+    if(v < HISTOGRAM_SUB_COUNT)
+        return (int)v;
+
+    // Find the highest bit
+    int msb = HISTOGRAM_SUB_BITS;
+    while((v >> (msb+1)) != 0) {
+
+        ++ msb;
+    }
+
+    // Keep the highest bits only
+    int shift = msb - HISTOGRAM_SUB_BITS + 1;
+    int sub = (int)(v >> shift);
+
+    return shift * (HISTOGRAM_SUB_COUNT/2) + sub;
+}
+
+
+// Get the largest value of a bucket
+int64 Histogram::getBucketValue(int b) {
+
+    if(b < HISTOGRAM_SUB_COUNT)
+        return b;
+
+    int shift = b / (HISTOGRAM_SUB_COUNT/2) - 1;
+    int64 sub = b - shift * (HISTOGRAM_SUB_COUNT/2);
+
+    return ((sub+1) << shift) - 1;
+}
+
+
+// Constructor
+Histogram::Histogram() {
+
+    clear();
+}
+
+
+// Record a value
+void Histogram::record(int64 v) {
+
+    if(v < 0) v = 0;
+
+    ++ counts[getBucket(v)];
+    ++ total;
+    if(v > maxValue)
+        maxValue = v;
+}
+
+
+// Forget everything
+void Histogram::clear() {
+
+    memset(counts, 0, sizeof(counts));
+    total = 0;
+    maxValue = 0;
+}
+
+
+// Get a percentile
+int64 Histogram::getPercentile(double p) {
+
+    if(total == 0)
+        return 0;
+
+    // Values at or below the percentile
+    uint64 target = (uint64)(p / 100.0 * total + 0.5);
+    if(target < 1) target = 1;
+    if(target > total) target = total;
+
+    uint64 sum = 0;
+    for(int i = 0; i < HISTOGRAM_BUCKETS; ++ i) {
+
+        sum += counts[i];
+        if(sum >= target) {
+
+            // The bucket may reach past the
+            // largest value recorded
+            int64 v = getBucketValue(i);
+            return v < maxValue ? v : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+
+// Write a row of the report
+void FrameStats::writeRow(FILE* f, const char* name, 
+    Histogram &h, double scale) {
+
+    fprintf(f, "%-10s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name,
+        h.getPercentile(50) * scale,
+        h.getPercentile(90) * scale,
+        h.getPercentile(99) * scale,
+        h.getPercentile(99.9) * scale,
+        h.getMax() * scale);
+}
+
+
+// Constructor
+FrameStats::FrameStats(int64 step) {
+
+    this->step = step;
+    clear();
+}
+
+
+// Record a frame
+void FrameStats::record(const FrameSample &s) {
+
+    frame.record(s.frame);
+    update.record(s.update);
+    draw.record(s.draw);
+    swap.record(s.swap);
+    ticks.record(s.ticks);
+
+    if(step > 0 && s.frame > step + step/2)
+        ++ late;
+    if(s.ticks > 1)
+        ++ bursts;
+    if(s.dropped)
+        ++ drops;
+}
+
+
+// Forget everything
+void FrameStats::clear() {
+
+    frame.clear();
+    update.clear();
+    draw.clear();
+    swap.clear();
+    ticks.clear();
+
+    late = 0;
+    bursts = 0;
+    drops = 0;
+}
+
+
+// Write a report
+bool FrameStats::write(std::string path) {
+
+    const double NS_TO_MS = 1.0 / 1000000.0;
+
+    FILE* f = fopen(path.c_str(), "w");
+    if(f == NULL)
+        return false;
+
+    uint64 count = frame.getTotal();
+    double pct = count > 0 ? 100.0 / count : 0.0;
+
+    fprintf(f, "Frames: %lu\n", (unsigned long)count);
+    fprintf(f, "Logic step: %.3f ms\n\n", step * NS_TO_MS);
+
+    fprintf(f, "%-10s %10s %10s %10s %10s %10s\n", 
+        "(ms)", "p50", "p90", "p99", "p99.9", "max");
+    writeRow(f, "frame", frame, NS_TO_MS);
+    writeRow(f, "update", update, NS_TO_MS);
+    writeRow(f, "draw", draw, NS_TO_MS);
+    writeRow(f, "swap", swap, NS_TO_MS);
+    fprintf(f, "\n");
+    writeRow(f, "steps", ticks, 1.0);
+
+    fprintf(f, "\nLate frames (over 1.5 steps): %lu (%.2f%%)\n",
+        (unsigned long)late, late * pct);
+    fprintf(f, "Catch-up bursts (over 1 step): %lu (%.2f%%), "
+        "longest %ld steps\n",
+        (unsigned long)bursts, bursts * pct, (long)ticks.getMax());
+    fprintf(f, "Dropped backlogs: %lu\n", (unsigned long)drops);
+
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,121 @@
+// Frame statistics
+// (c) 2019 Jani Nykänen
+
+#ifndef __FRAME_STATS_H__
+#define __FRAME_STATS_H__
+
+#include "Types.hpp"
+
+#include <string>
+#include <cstdio>
+
+// Bits kept of every value. Values are recorded
+// with a relative error of 1/16 at most
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+// Enough buckets for any positive 64-bit value
+#define HISTOGRAM_BUCKETS ((64-HISTOGRAM_SUB_BITS+1)*HISTOGRAM_SUB_COUNT/2 \
+    + HISTOGRAM_SUB_COUNT/2)
+
+
+// Log-linear histogram. Small values are stored
+// exactly, larger ones with a fixed relative
+// precision, so it works for nanoseconds and
+// counts alike
+class Histogram {
+
+private:
+
+    // Counts per bucket
+    uint64 counts[HISTOGRAM_BUCKETS];
+    // Values recorded
+    uint64 total;
+    // Largest value, exact
+    int64 maxValue;
+
+    // Get the bucket of a value
+    static int getBucket(int64 v);
+    // Get the largest value of a bucket
+    static int64 getBucketValue(int b);
+
+public:
+
+    // Constructor
+    Histogram();
+
+    // Record a value, negative ones count as 0
+    void record(int64 v);
+    // Forget everything
+    void clear();
+
+    // Get a percentile, p in [0,100]
+    int64 getPercentile(double p);
+
+    // Getters
+    inline uint64 getTotal() { return total; }
+    inline int64 getMax() { return maxValue; }
+};
+
+
+// Times of a frame, in nanoseconds
+struct FrameSample {
+
+    // Since the previous frame
+    int64 frame;
+    // Logic steps
+    int64 update;
+    // Drawing
+    int64 draw;
+    // Swapping, including waiting for the screen
+    int64 swap;
+    // Logic steps taken
+    int ticks;
+    // Was the time left behind dropped
+    bool dropped;
+};
+
+
+// Frame statistics. Collects frame samples to
+// histograms and writes a report of them
+class FrameStats {
+
+private:
+
+    // Histograms
+    Histogram frame;
+    Histogram update;
+    Histogram draw;
+    Histogram swap;
+    Histogram ticks;
+
+    // Length of a logic step
+    int64 step;
+    // Frames longer than 1.5 steps
+    uint64 late;
+    // Frames with more than one step
+    uint64 bursts;
+    // Frames that dropped time
+    uint64 drops;
+
+    // Write a row of the report
+    void writeRow(FILE* f, const char* name, Histogram &h, double scale);
+
+public:
+
+    // Constructor
+    FrameStats(int64 step = 0);
+
+    // Record a frame
+    void record(const FrameSample &s);
+    // Forget everything
+    void clear();
+
+    // Write a report. Returns false if the
+    // file could not be opened
+    bool write(std::string path);
+
+    // Getters
+    inline uint64 getFrameCount() { return frame.getTotal(); }
+};
+
+#endif // __FRAME_STATS_H__
@@ -0,0 +1,116 @@
+// Framebuffer
+// (c) 2019 Jani Nykänen
+
+#include "Framebuffer.hpp"
+
+#include "GLState.hpp"
+
+#include "../Lib/WritePNG.hpp"
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+
+// Constructor
+Framebuffer::Framebuffer(int width, int height) {
+
+    this->width = width;
+    this->height = height;
+
+    // Create color texture
+    glGenTextures(1, &texture);
+    GLState::bindTexture(texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+        GL_UNSIGNED_BYTE, NULL);
+
+    // Create framebuffer
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, texture, 0);
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) 
+        != GL_FRAMEBUFFER_COMPLETE) {
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        throw std::runtime_error("Failed to create a framebuffer!");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+
+// Destructor
+Framebuffer::~Framebuffer() {
+
+    glDeleteFramebuffers(1, &fbo);
+    GLState::deleteTexture(texture);
+}
+
+
+// Draw to this framebuffer
+void Framebuffer::bind() {
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
+
+
+// Draw to the window again
+void Framebuffer::unbind() {
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+
+// Read the pixels
+void Framebuffer::readPixels(std::vector<uint8> &out) {
+
+    const int ROW = width*4;
+
+    out.resize(width*height*4);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+        (void*)&out[0]);
+
+    // GL starts from the bottom row
+    std::vector<uint8> row (ROW);
+    for(int y = 0; y < height/2; ++ y) {
+
+        std::copy(out.begin() + y*ROW, out.begin() + (y+1)*ROW,
+            row.begin());
+        std::copy(out.begin() + (height-1-y)*ROW, 
+            out.begin() + (height-y)*ROW,
+            out.begin() + y*ROW);
+        std::copy(row.begin(), row.end(), 
+            out.begin() + (height-1-y)*ROW);
+    }
+}
+
+
+// Save the pixels to a file
+void Framebuffer::save(std::string path, bool raw) {
+
+    std::vector<uint8> data;
+    readPixels(data);
+
+    if(!raw) {
+
+        writePNG(path, &data[0], width, height);
+        return;
+    }
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if(f == NULL) {
+
+        throw std::runtime_error("Failed to create a file in " + path);
+    }
+    fwrite(&data[0], 1, data.size(), f);
+    fclose(f);
+}
@@ -0,0 +1,48 @@
+// Framebuffer
+// (c) 2019 Jani Nykänen
+
+#ifndef __FRAMEBUFFER_H__
+#define __FRAMEBUFFER_H__
+
+#include "Types.hpp"
+
+#include <vector>
+#include <string>
+
+// Offscreen render target. Used when there
+// is no visible window to draw to
+class Framebuffer {
+
+private:
+
+    // Dimensions
+    int width;
+    int height;
+    // Framebuffer object
+    uint32 fbo;
+    // Color texture
+    uint32 texture;
+
+public:
+
+    // Constructor
+    Framebuffer(int width, int height);
+    // Destructor
+    ~Framebuffer();
+
+    // Draw to this framebuffer
+    void bind();
+    // Draw to the window again
+    void unbind();
+
+    // Read the pixels as RGBA, top row first
+    void readPixels(std::vector<uint8> &out);
+    // Save the pixels to a PNG or a raw RGBA file
+    void save(std::string path, bool raw = false);
+
+    // Getters
+    inline int getWidth() { return width; }
+    inline int getHeight() { return height; }
+};
+
+#endif // __FRAMEBUFFER_H__
@@ -0,0 +1,236 @@
+// GL state cache
+// (c) 2019 Jani Nykänen
+
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+
+#include <cstring>
+
+
+// Static members
+uint32 GLState::program = 0;
+int GLState::activeUnit = 0;
+uint32 GLState::textures[GL_STATE_TEXTURE_UNITS] = {0};
+uint32 GLState::arrayBuffer = 0;
+uint32 GLState::elementBuffer = 0;
+int GLState::attribs[GL_STATE_ATTRIBS] = {0};
+uint32 GLState::vertexSource = 0;
+std::map<uint32, std::vector<UniformValue> > GLState::uniforms;
+std::vector<UniformValue>* GLState::progUniforms = NULL;
+int GLState::issued = 0;
+int GLState::skipped = 0;
+int GLState::lastIssued = 0;
+int GLState::lastSkipped = 0;
+
+
+// Count a state change
+bool GLState::count(bool changed) {
+
+    if(changed)
+        ++ issued;
+    else
+        ++ skipped;
+
+    return changed;
+}
+
+
+// Compare a uniform value and store it
+bool GLState::updateUniform(int loc, const float* v, int n) {
+
+    // Not found in the shader, nothing to upload
+    if(loc < 0 || progUniforms == NULL)
+        return false;
+
+    if(loc >= (int)progUniforms->size())
+        progUniforms->resize(loc+1);
+
+    UniformValue &u = (*progUniforms)[loc];
+    if(u.valid && memcmp(u.v, v, n*sizeof(float)) == 0)
+        return count(false);
+
+    memcpy(u.v, v, n*sizeof(float));
+    u.valid = true;
+    return count(true);
+}
+
+
+// Forget everything
+void GLState::invalidate() {
+
+    // Zero is a valid binding, so use something
+    // no object is going to have
+    const uint32 UNKNOWN = 0xFFFFFFFF;
+
+    program = UNKNOWN;
+    activeUnit = -1;
+    for(int i = 0; i < GL_STATE_TEXTURE_UNITS; ++ i) {
+
+        textures[i] = UNKNOWN;
+    }
+    arrayBuffer = UNKNOWN;
+    elementBuffer = UNKNOWN;
+    for(int i = 0; i < GL_STATE_ATTRIBS; ++ i) {
+
+        attribs[i] = -1;
+    }
+    vertexSource = 0;
+    uniforms.clear();
+    progUniforms = NULL;
+}
+
+
+// Use a program
+void GLState::useProgram(uint32 prog) {
+
+    if(!count(program != prog))
+        return;
+
+    program = prog;
+    progUniforms = &uniforms[prog];
+    glUseProgram(prog);
+}
+
+
+// Delete a program
+void GLState::deleteProgram(uint32 prog) {
+
+    glDeleteProgram(prog);
+
+    uniforms.erase(prog);
+    if(program == prog) {
+
+        // The program stays in use until another
+        // one is bound, but its uniforms are gone
+        program = 0;
+        progUniforms = NULL;
+    }
+}
+
+
+// Bind a texture to a unit
+void GLState::bindTexture(uint32 tex, int unit) {
+
+    if(!count(textures[unit] != tex))
+        return;
+
+    if(activeUnit != unit) {
+
+        activeUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    textures[unit] = tex;
+    glBindTexture(GL_TEXTURE_2D, tex);
+}
+
+
+// Delete a texture
+void GLState::deleteTexture(uint32 tex) {
+
+    glDeleteTextures(1, &tex);
+
+    // Deleted textures are unbound
+    for(int i = 0; i < GL_STATE_TEXTURE_UNITS; ++ i) {
+
+        if(textures[i] == tex)
+            textures[i] = 0;
+    }
+}
+
+
+// Bind a buffer
+void GLState::bindBuffer(uint32 target, uint32 buf) {
+
+    uint32* bound = target == GL_ELEMENT_ARRAY_BUFFER ?
+        &elementBuffer : &arrayBuffer;
+
+    if(!count(*bound != buf))
+        return;
+
+    *bound = buf;
+    glBindBuffer(target, buf);
+}
+
+
+// Delete a buffer
+void GLState::deleteBuffer(uint32 buf) {
+
+    glDeleteBuffers(1, &buf);
+
+    // Deleted buffers are unbound
+    if(arrayBuffer == buf)
+        arrayBuffer = 0;
+    if(elementBuffer == buf)
+        elementBuffer = 0;
+    if(vertexSource == buf)
+        vertexSource = 0;
+}
+
+
+// Enable vertex attribute arrays
+void GLState::enableAttribs(uint32 mask) {
+
+    int enable;
+    bool changed = false;
+    for(int i = 0; i < GL_STATE_ATTRIBS; ++ i) {
+
+        enable = (mask & (1 << i)) != 0 ? 1 : 0;
+        if(attribs[i] == enable)
+            continue;
+
+        count(true);
+        changed = true;
+
+        attribs[i] = enable;
+        if(enable)
+            glEnableVertexAttribArray(i);
+        else
+            glDisableVertexAttribArray(i);
+    }
+
+    if(!changed)
+        count(false);
+}
+
+
+// Set the source of vertex attribute pointers
+bool GLState::setVertexSource(uint32 buf) {
+
+    if(!count(vertexSource != buf))
+        return false;
+
+    vertexSource = buf;
+    return true;
+}
+
+
+// Set uniforms
+void GLState::setUniform(int loc, int v) {
+
+    float f = (float)v;
+    if(updateUniform(loc, &f, 1))
+        glUniform1i(loc, v);
+}
+void GLState::setUniform(int loc, float x, float y, float z, float w) {
+
+    float v[] = {x, y, z, w};
+    if(updateUniform(loc, v, 4))
+        glUniform4f(loc, x, y, z, w);
+}
+void GLState::setUniformMatrix3(int loc, const float* m) {
+
+    if(updateUniform(loc, m, 9))
+        glUniformMatrix3fv(loc, 1, false, m);
+}
+
+
+// Start counting a new frame
+void GLState::endFrame() {
+
+    lastIssued = issued;
+    lastSkipped = skipped;
+    issued = 0;
+    skipped = 0;
+}
@@ -0,0 +1,109 @@
+// GL state cache
+// (c) 2019 Jani Nykänen
+
+#ifndef __GL_STATE_H__
+#define __GL_STATE_H__
+
+#include "Types.hpp"
+
+#include <vector>
+#include <map>
+
+// Maximum number of texture units tracked
+#define GL_STATE_TEXTURE_UNITS 8
+// Maximum number of vertex attributes tracked
+#define GL_STATE_ATTRIBS 8
+
+// A cached uniform value
+struct UniformValue {
+
+    bool valid;
+    float v[9];
+
+    // Constructor
+    inline UniformValue() { valid = false; }
+};
+
+
+// GL state cache. Remembers what has been bound
+// and uploaded, and skips calls that would not
+// change anything
+class GLState {
+
+private:
+
+    // Bound program
+    static uint32 program;
+    // Active texture unit
+    static int activeUnit;
+    // Bound textures, per unit
+    static uint32 textures[GL_STATE_TEXTURE_UNITS];
+    // Bound buffers
+    static uint32 arrayBuffer;
+    static uint32 elementBuffer;
+    // Vertex attributes: 1 enabled, 0 disabled,
+    // -1 not known
+    static int attribs[GL_STATE_ATTRIBS];
+    // The buffer vertex attribute pointers were
+    // last set for
+    static uint32 vertexSource;
+
+    // Uniform values, per program
+    static std::map<uint32, std::vector<UniformValue> > uniforms;
+    // Uniforms of the bound program
+    static std::vector<UniformValue>* progUniforms;
+
+    // Counters
+    static int issued;
+    static int skipped;
+    static int lastIssued;
+    static int lastSkipped;
+
+    // Count a state change
+    static bool count(bool changed);
+    // Compare a uniform value and store it
+    static bool updateUniform(int loc, const float* v, int n);
+
+public:
+
+    // Forget everything, for when the GL state
+    // has been changed elsewhere
+    static void invalidate();
+
+    // Use a program
+    static void useProgram(uint32 prog);
+    // Delete a program
+    static void deleteProgram(uint32 prog);
+
+    // Bind a texture to a unit
+    static void bindTexture(uint32 tex, int unit = 0);
+    // Delete a texture
+    static void deleteTexture(uint32 tex);
+
+    // Bind a buffer
+    static void bindBuffer(uint32 target, uint32 buf);
+    // Delete a buffer
+    static void deleteBuffer(uint32 buf);
+
+    // Enable the vertex attribute arrays given as
+    // a bit mask, and disable the rest
+    static void enableAttribs(uint32 mask);
+    // Tell that the vertex attribute pointers are about
+    // to be set for the given buffer. Returns false if
+    // they already are
+    static bool setVertexSource(uint32 buf);
+
+    // Set uniforms of the bound program
+    static void setUniform(int loc, int v);
+    static void setUniform(int loc, float x, float y, float z, float w);
+    static void setUniformMatrix3(int loc, const float* m);
+
+    // Start counting a new frame
+    static void endFrame();
+
+    // Counters of the previous frame
+    inline static int getIssued() { return lastIssued; }
+    inline static int getSkipped() { return lastSkipped; }
+};
+
+#endif // __GL_STATE_H__
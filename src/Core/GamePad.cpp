@@ -51,7 +51,14 @@ GamePad::GamePad(std::string confPath) {
         parseCSV(conf.getParam(i), key, button);
         name = conf.getKey(i);
 
-        // Add
+        // Add. Special button data can't be
+        // queried, and the first of the same
+        // name is the one found
+        if(name[0] != '@' && 
+           buttonIndex.find(hashName(name)) == buttonIndex.end()) {
+
+            buttonIndex[hashName(name)] = buttons.size();
+        }
         buttons.push_back(PadButton(name, key, button));
     }
 
@@ -123,22 +130,13 @@ void GamePad::update(InputListener* input) {
 
 
 // Get button
-int GamePad::getButton(std::string name) {
+int GamePad::getButton(NameID id) {
     
-    // Special button data is ignored
-    if(name.length() >= 1 && name[0] == '@')
+    auto it = buttonIndex.find(id);
+    if(it == buttonIndex.end())
         return State::Up;
 
-    std::string s;
-    for(int i = 0; i < buttons.size(); ++ i) {
-
-        s = buttons[i].name;
-        if(s[0] != '@' && s == name) {
-
-            return buttons[i].state;
-        }
-    }
-    return State::Up;
+    return buttons[it->second].state;
 }
 
 
@@ -6,8 +6,10 @@
 
 #include "InputListener.hpp"
 #include "Types.hpp"
+#include "Hash.hpp"
 
 #include <string>
+#include <unordered_map>
 
 // Gamepad button
 struct PadButton {
@@ -37,6 +39,9 @@ private:
 
     // Buttons
     std::vector<PadButton> buttons;
+    // Name ID to button index, special
+    // buttons left out
+    std::unordered_map<NameID, int> buttonIndex;
 
     // Joy axes
     Point stickAxes;
@@ -51,8 +56,13 @@ public:
     // Update
     void update(InputListener* input);
 
-    // Get button
-    int getButton(std::string name);
+    // Get button. Use NAME_ID to hash
+    // literals at compile time
+    int getButton(NameID id);
+    inline int getButton(std::string name) {
+
+        return getButton(hashName(name));
+    }
     // Get stick
     inline Vector2 getStick() {
         return stick;
@@ -23,32 +23,41 @@ Graphics::Graphics() : GraphicsCore() {
 // Clear screen
 void Graphics::clearScreen(float r, float g, float b) {
 
+    // Batched quads must be drawn before clearing
+    flush();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glClearColor(r, g, b, 1.0f);
 }
 
 
 
+// Draw everything and start a new frame
+void Graphics::endFrame() {
+
+    GraphicsCore::endFrame();
+    // Nothing refers to the dropped
+    // text meshes anymore
+    textCache.endFrame();
+}
+
+
 // Set color
 void Graphics::setColor(float r, float g, float b, float a) {
 
+    // The color is stored to the vertices
     gcolor = Color(r, g, b, a);
-    shader->setColorUniforms(gcolor);
 }
 
 
 // Draw a filled rectangle
 void Graphics::fillRect(float x, float y, float w, float h) {
 
-    // Bind texture
-	bmpWhite->bind();
-		
-	// Pass position & dimension data to the shader
-	shader->setVertexUniforms(Vector2(x, y), Vector2(w, h));
-	shader->setUVUniforms(Vector2(0, 0), Vector2(1, 1));
-	
-    // Draw
-	rectMesh->draw();
+    // Sample the center of the white bitmap
+    float u = bmpWhite->getU(bmpWhite->getWidth() / 2.0f);
+    float v = bmpWhite->getV(bmpWhite->getHeight() / 2.0f);
+
+    pushQuad(bmpWhite, x, y, w, h, u, v, u, v, gcolor);
 }
 
 
@@ -61,12 +70,7 @@ void Graphics::drawBitmap(Bitmap* bmp, float sx, float sy, float sw, float sh,
             throw std::runtime_error("Null bitmap error!");
         }
 
-        // Bind bitmap
-		bmp->bind();
-		
 		// Flip
-		float w = (float)bmp->getWidth();
-	    float h = (float)bmp->getHeight();
 	    if( (flip & Flip::Horizontal) != 0) {
 
 	        dx += dw;
@@ -78,13 +82,11 @@ void Graphics::drawBitmap(Bitmap* bmp, float sx, float sy, float sw, float sh,
 	        dh *= -1;
 	    }
 
-        // Pass data to shaders
-        shader->setVertexUniforms(Vector2(dx, dy), Vector2(dw, dh));
-	    shader->setUVUniforms(Vector2(sx / w , sy / h ), 
-            Vector2(sw / w , sh / h));
-	    
-        // Draw
-	    rectMesh->draw();
+        // Add to the batch
+        pushQuad(bmp, dx, dy, dw, dh, 
+            bmp->getU(sx), bmp->getV(sy), 
+            bmp->getU(sx+sw), bmp->getV(sy+sh), 
+            gcolor);
 }
 void Graphics::drawBitmap(Bitmap* bmp, float sx, float sy, float sw, float sh, 
         float dx, float dy, 
@@ -114,15 +116,46 @@ void Graphics::drawBitmap(Bitmap* bmp, float dx, float dy, int flip) {
     drawBitmap(bmp, dx, dy, bmp->getWidth(), bmp->getHeight(), flip);
 }
 
-// Draw text
-void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy, 
-                int xoff, int yoff, 
-		        float scale, bool center) {
+// Draw a bitmap region as an instance
+void Graphics::drawInstance(Bitmap* bmp, float sx, float sy, float sw, float sh,
+        float dx, float dy, float dw, float dh,
+        float x, float y, float angle, float scale) {
 
     if(bmp == NULL) {
         throw std::runtime_error("Null bitmap error!");
     }
 
+    SpriteInstance inst;
+    inst.x = x;
+    inst.y = y;
+    inst.angle = angle;
+    inst.sx = scale;
+    inst.sy = scale;
+    inst.dx = dx;
+    inst.dy = dy;
+    inst.dw = dw;
+    inst.dh = dh;
+    inst.u1 = bmp->getU(sx);
+    inst.v1 = bmp->getV(sy);
+    inst.u2 = bmp->getU(sx+sw);
+    inst.v2 = bmp->getV(sy+sh);
+    inst.color = gcolor;
+
+    pushInstance(bmp, inst);
+}
+
+
+// Draw a mesh
+void Graphics::drawMesh(Mesh* mesh) {
+
+    GraphicsCore::drawMesh(mesh, gcolor);
+}
+
+
+// Lay out glyphs
+void Graphics::layoutText(Bitmap* bmp, std::string text,
+    float dx, float dy, int xoff, int yoff, float scale) {
+
     int cw = (bmp->getWidth()) / 16;
     int ch = cw;
     int len = text.length();
@@ -131,14 +164,7 @@ void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy,
     float y = dy;
     unsigned char c;
 
-    // Center the text
-    if (center)
-    {
-        dx -= ((len + 1) / 2.0f * (cw + xoff) * scale);
-        x = dx;
-    }
-
-    // Draw every character
+    // Add every character
     float sx, sy;
     for (int i = 0; i < len; ++i)
     {
@@ -154,7 +180,6 @@ void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy,
 
         sx = c % 16;
         sy = (c / 16);
-        // Draw character
         drawBitmap(bmp, sx * cw, sy * ch, cw, ch,
             x, y,
             cw * scale, ch * scale);
@@ -164,6 +189,79 @@ void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy,
 }
 
 
+// Get a text mesh
+Mesh* Graphics::getTextMesh(const TextKey &key) {
+
+    Mesh* mesh = textCache.get(key);
+    if(mesh != NULL)
+        return mesh;
+
+    // Not cached, build a new one. Glyphs are
+    // white so the mesh can be tinted with
+    // the current color
+    Color c = gcolor;
+    mesh = textCache.add(key);
+    beginMesh(mesh);
+
+    setColor();
+    layoutText(key.font, key.text, 0, 0, 
+        key.xoff, key.yoff, 1.0f);
+
+    endMesh();
+    gcolor = c;
+
+    return mesh;
+}
+
+
+// Draw a text mesh
+void Graphics::drawTextMesh(Mesh* mesh, int x, int y, float scale,
+    Color tint) {
+
+    Affine2 m = transf;
+    m.translate(x, y);
+    m.scale(scale, scale);
+    GraphicsCore::drawMesh(mesh, m, tint);
+}
+
+
+// Compute where the text starts
+int Graphics::getTextOrigin(Bitmap* bmp, std::string text, int dx,
+    int xoff, float scale, bool center) {
+
+    if(!center)
+        return dx;
+
+    int cw = (bmp->getWidth()) / 16;
+    int len = text.length();
+
+    dx -= ((len + 1) / 2.0f * (cw + xoff) * scale);
+    return dx;
+}
+
+
+// Draw text
+void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy, 
+                int xoff, int yoff, 
+		        float scale, bool center) {
+
+    if(bmp == NULL) {
+        throw std::runtime_error("Null bitmap error!");
+    }
+    if(text.empty()) return;
+
+    TextKey key;
+    key.text = text;
+    key.font = bmp;
+    key.xoff = xoff;
+    key.yoff = yoff;
+
+    drawTextMesh(getTextMesh(key), 
+        getTextOrigin(bmp, text, dx, xoff, scale, center), dy,
+        scale, gcolor);
+}
+
+
 // Draw text with a shadow
 void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy, 
                 int xoff, int yoff, 
@@ -171,14 +269,24 @@ void Graphics::drawText(Bitmap* bmp, std::string text, int dx, int dy,
                 float trans, float scale,
                 bool center) {
 
-    Color c = gcolor;
+    if(bmp == NULL) {
+        throw std::runtime_error("Null bitmap error!");
+    }
+    if(text.empty()) return;
 
-    // Draw shadow
-    setColor(0, 0, 0, trans*c.a);
-    drawText(bmp, text, dx + shadowX, dy + shadowY, 
-        xoff, yoff, scale, center);    
+    TextKey key;
+    key.text = text;
+    key.font = bmp;
+    key.xoff = xoff;
+    key.yoff = yoff;
+    Mesh* mesh = getTextMesh(key);
 
-    // Draw base text
-    setColor(c.r, c.g, c.b, c.a);
-    drawText(bmp, text, dx, dy, xoff, yoff, scale, center);    
+    // The shadow is the same mesh in black, moved
+    // by the offset in pixels, not scaled
+    Color c = gcolor;
+    drawTextMesh(mesh, 
+        getTextOrigin(bmp, text, (int)(dx + shadowX), xoff, scale, center),
+        (int)(dy + shadowY), scale, Color(0, 0, 0, trans*c.a));
+    drawTextMesh(mesh, getTextOrigin(bmp, text, dx, xoff, scale, center), 
+        dy, scale, c);
 }
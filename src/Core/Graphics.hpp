@@ -5,6 +5,7 @@
 #define __GRAPHICS_H__
 
 #include "GraphicsCore.hpp"
+#include "TextCache.hpp"
 
 // Flipping flags
 namespace Flip {
@@ -26,12 +27,29 @@ private:
 
     // Color storage
     Color gcolor;
+    // Cached text meshes
+    TextCache textCache;
+
+    // Lay out glyphs, starting from the origin
+    void layoutText(Bitmap* bmp, std::string text,
+        float dx, float dy, int xoff, int yoff, float scale);
+    // Get a text mesh, build it if not cached
+    Mesh* getTextMesh(const TextKey &key);
+    // Draw a text mesh with its origin at (x, y),
+    // scaled & tinted
+    void drawTextMesh(Mesh* mesh, int x, int y, float scale, Color tint);
+    // Compute where the text starts
+    int getTextOrigin(Bitmap* bmp, std::string text, int dx,
+        int xoff, float scale, bool center);
 
 public:
 
     // Constructor
     Graphics();
 
+    // Draw everything and start a new frame
+    void endFrame();
+
     // Clear screen
     void clearScreen(float r, float g, float b);
     
@@ -51,6 +69,16 @@ public:
         int flip = Flip::None);
     void drawBitmap(Bitmap* bmp, float dx, float dy, int flip = Flip::None);
 
+    // Draw a bitmap region as an instance. The destination
+    // rectangle is scaled, rotated and moved to (x, y).
+    // Consecutive instances cost one draw call
+    void drawInstance(Bitmap* bmp, float sx, float sy, float sw, float sh,
+        float dx, float dy, float dw, float dh,
+        float x, float y, float angle = 0.0f, float scale = 1.0f);
+
+    // Draw a mesh, tinted with the current color
+    void drawMesh(Mesh* mesh);
+
     // Draw text
     void drawText(Bitmap* bmp, std::string text, int dx, int dy, 
                 int xoff, int yoff, 
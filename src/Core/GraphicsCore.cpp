@@ -9,22 +9,148 @@
 #include <GL/gl.h>
 
 
-// Create rectangular mesh
-void GraphicsCore::createRectMesh() {
+// Prepare the sprite batch for a quad
+void GraphicsCore::prepareBatch() {
 
-    // Data
-    float vertices[] = {0,0, 1,0, 1,1, 0,1};
-    float uvs[] = {0,0, 1,0, 1,1, 0,1};
-    uint16 indices[] = {0,1,2, 2,3,0};
+    // Keep the drawing order
+    if(instances != NULL && instances->getCount() > 0) {
 
-    // Create mesh
-    rectMesh = new Mesh(
-        vertices, uvs, indices,
-        2*4, 2*4, 6
-    );
+        flushInstances();
+    }
 
-    // Bind for use
-    rectMesh->bind();
+    // Batched quads are already transformed, so
+    // restore the defaults if a mesh changed them
+    if(meshUniforms) {
+
+        shader->setMatrixUniforms(Affine2());
+        shader->setColorUniforms(Color(1, 1, 1, 1));
+        meshUniforms = false;
+    }
+}
+
+
+// Add a quad
+void GraphicsCore::pushQuad(Bitmap* bmp, float x, float y, float w, float h,
+    float u1, float v1, float u2, float v2, Color col) {
+
+    // Store to a mesh
+    if(meshTarget != NULL) {
+
+        Vector2 corners[4];
+        corners[0] = Vector2(x, y);
+        corners[1] = Vector2(x+w, y);
+        corners[2] = Vector2(x+w, y+h);
+        corners[3] = Vector2(x, y+h);
+
+        meshTarget->pushQuad(bmp, corners, u1, v1, u2, v2, col);
+        return;
+    }
+
+    RenderCommand* c = pushCommand(RenderKind::Quad, bmp);
+    c->m = transf;
+    c->inst.dx = x; c->inst.dy = y;
+    c->inst.dw = w; c->inst.dh = h;
+    c->inst.u1 = u1; c->inst.v1 = v1;
+    c->inst.u2 = u2; c->inst.v2 = v2;
+    c->inst.color = col;
+}
+
+
+// Add a sprite instance
+void GraphicsCore::pushInstance(Bitmap* bmp, SpriteInstance &inst) {
+
+    // Meshes store quads without the view
+    // transformation
+    Affine2 m = meshTarget != NULL ? Affine2() : transf;
+    m.translate(inst.x, inst.y);
+    m.rotate(inst.angle);
+    m.scale(inst.sx, inst.sy);
+
+    if(meshTarget != NULL) {
+
+        Vector2 corners[4];
+        m.transformRect(inst.dx, inst.dy, inst.dw, inst.dh, 
+            (float*)corners, 2);
+        meshTarget->pushQuad(bmp, corners, 
+            inst.u1, inst.v1, inst.u2, inst.v2, inst.color);
+        return;
+    }
+
+    // No instancing, transform on the CPU instead
+    RenderCommand* c = pushCommand(
+        instances == NULL ? RenderKind::Quad : RenderKind::Instance, bmp);
+    c->m = m;
+    c->inst = inst;
+}
+
+
+// Add a command to the queue
+RenderCommand* GraphicsCore::pushCommand(int kind, Bitmap* bmp) {
+
+    if(queue.isFull()) {
+
+        flush();
+    }
+    return queue.push(kind, bmp);
+}
+
+
+// Draw a queued command
+void GraphicsCore::submit(RenderCommand* c) {
+
+    SpriteInstance &inst = c->inst;
+
+    switch(c->kind) {
+
+    case RenderKind::Quad:
+
+        prepareBatch();
+        batch->pushQuad(c->bmp, c->m, inst.dx, inst.dy, inst.dw, inst.dh,
+            inst.u1, inst.v1, inst.u2, inst.v2, inst.color);
+        break;
+
+    case RenderKind::Instance:
+
+        // Keep the drawing order
+        batch->flush();
+        if(!instances->canPush(c->bmp)) {
+
+            flushInstances();
+        }
+        instances->push(c->bmp, c->m, inst);
+        break;
+
+    case RenderKind::Mesh:
+
+        // Keep the drawing order
+        flushInstances();
+        batch->flush();
+
+        // The defaults are restored when the next
+        // quad is batched
+        shader->setMatrixUniforms(c->m);
+        shader->setColorUniforms(inst.color);
+        meshUniforms = true;
+
+        c->mesh->draw();
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+// Draw the batched instances
+void GraphicsCore::flushInstances() {
+
+    if(instances == NULL || instances->getCount() == 0)
+        return;
+
+    instShader->useShader();
+    instances->flush();
+
+    shader->useShader();
 }
 
 
@@ -39,15 +165,32 @@ GraphicsCore::GraphicsCore() : Transformations() {
 	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, 
         GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Create shader
+    // Create shaders
     shader = new Shader();
-    // Use it
+    instShader = NULL;
+    if(InstanceBatch::isSupported()) {
+
+        instShader = new Shader(ShaderType::Instanced);
+    }
+    // Use the default one
     shader->useShader();
 
-    // Create rectangular mesh
-    createRectMesh();
+    // Create sprite batch
+    batch = new SpriteBatch();
+    batch->bind();
+    // Create instance batch, if supported
+    instances = NULL;
+    if(instShader != NULL) {
+
+        instances = new InstanceBatch();
+    }
     // Create white texture
-    bmpWhite = new Bitmap(1, 1);
+    bmpDefaultWhite = new Bitmap(1, 1);
+    bmpWhite = bmpDefaultWhite;
+
+    meshTarget = NULL;
+    meshUniforms = false;
+    interp = 1.0f;
 }
 
 
@@ -55,8 +198,10 @@ GraphicsCore::GraphicsCore() : Transformations() {
 GraphicsCore::~GraphicsCore() {
 
     delete shader;
-    delete bmpWhite;
-    delete rectMesh;
+    delete instShader;
+    delete bmpDefaultWhite;
+    delete batch;
+    delete instances;
 }
 
 
@@ -66,6 +211,9 @@ void GraphicsCore::resize(int width, int height) {
     // Pass size to the transformations
     fbSize = Vector2(width, height);
 
+    // Whatever is batched belongs to the old viewport
+    flush();
+
     // Resize viewport
     glViewport(0, 0, width, height);
 }
@@ -74,5 +222,82 @@ void GraphicsCore::resize(int width, int height) {
 // Use transformations
 void GraphicsCore::useTransf() {
 
-    passToShader(shader);
+    // Quads are transformed on the CPU, so nothing
+    // needs to be passed to the shader
+    transf = getCombined();
+}
+
+
+// Draw everything queued so far
+void GraphicsCore::flush() {
+
+    queue.sort();
+    for(int i = 0; i < queue.getCount(); ++ i) {
+
+        submit(queue.get(i));
+    }
+    queue.clear();
+
+    flushInstances();
+    batch->flush();
+}
+
+
+// Draw everything and start a new frame
+void GraphicsCore::endFrame() {
+
+    flush();
+
+    queue.setLayer(DrawLayer::Default);
+    resetStack();
+}
+
+
+// Set the layer for the upcoming draws
+void GraphicsCore::setLayer(int layer, bool ordered) {
+
+    queue.setLayer(layer, ordered);
 }
+
+
+// Set the bitmap used for filled shapes
+void GraphicsCore::setWhiteBitmap(Bitmap* bmp) {
+
+    bmpWhite = bmp == NULL ? bmpDefaultWhite : bmp;
+}
+
+
+// Start recording quads to a mesh
+void GraphicsCore::beginMesh(Mesh* mesh) {
+
+    // Quads go straight to the mesh, so the
+    // queue is left as it is
+    meshTarget = mesh;
+    meshTarget->clear();
+}
+
+
+// Stop recording
+void GraphicsCore::endMesh() {
+
+    meshTarget = NULL;
+}
+
+
+// Draw a mesh using the active transformation
+void GraphicsCore::drawMesh(Mesh* mesh, Color tint) {
+
+    drawMesh(mesh, transf, tint);
+}
+
+
+// Draw a mesh using the given transformation
+void GraphicsCore::drawMesh(Mesh* mesh, Affine2 m, Color tint) {
+
+    if(mesh->getQuadCount() == 0) return;
+
+    RenderCommand* c = pushCommand(RenderKind::Mesh, NULL);
+    c->mesh = mesh;
+    c->m = m;
+    c->inst.color = tint;
+}
\ No newline at end of file
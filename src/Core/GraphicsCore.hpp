@@ -6,27 +6,59 @@
 
 #include "Shader.hpp"
 #include "Bitmap.hpp"
+#include "SpriteBatch.hpp"
+#include "InstanceBatch.hpp"
 #include "Mesh.hpp"
+#include "RenderQueue.hpp"
 #include "Transformations.hpp"
 
 
 // Graphics class
 class GraphicsCore : public Transformations {
 
-private:
-
-    // Create rectangular mesh
-    void createRectMesh();
-
 protected:
 
     // Shader
     Shader* shader =NULL;
+    // Instanced shader, NULL if not supported
+    Shader* instShader;
 
-    // Rectangular mesh
-    Mesh* rectMesh;
+    // Sprite batch
+    SpriteBatch* batch;
+    // Instance batch, NULL if not supported
+    InstanceBatch* instances;
+    // Draws of the frame, in sorted order
+    RenderQueue queue;
     // White texture
     Bitmap* bmpWhite;
+    // Default white texture, used if no
+    // other is given
+    Bitmap* bmpDefaultWhite;
+
+    // Active transformation (view & model)
+    Affine2 transf;
+    // Mesh being recorded, if any
+    Mesh* meshTarget;
+    // Do the shader uniforms differ from the
+    // batch defaults
+    bool meshUniforms;
+    // How far the frame is between the previous
+    // and the latest logic step
+    float interp;
+
+    // Prepare the sprite batch for a quad
+    void prepareBatch();
+    // Add a quad
+    void pushQuad(Bitmap* bmp, float x, float y, float w, float h,
+        float u1, float v1, float u2, float v2, Color col);
+    // Add a sprite instance
+    void pushInstance(Bitmap* bmp, SpriteInstance &inst);
+    // Draw the batched instances
+    void flushInstances();
+    // Add a command to the queue
+    RenderCommand* pushCommand(int kind, Bitmap* bmp);
+    // Draw a queued command
+    void submit(RenderCommand* c);
 
 public:
 
@@ -40,6 +72,50 @@ public:
 
     // Use transformations
     void useTransf();
+    // Draw everything queued so far
+    void flush();
+    // Draw everything, reset the layer and the
+    // transformation stack for a new frame
+    void endFrame();
+
+    // Set the layer for the upcoming draws. Layers
+    // are drawn from the lowest up. An unordered
+    // layer may draw its content in any order,
+    // grouped by texture, so it must not overlap
+    // with different textures
+    void setLayer(int layer, bool ordered = true);
+
+    // Set how far the frame is between the
+    // previous and the latest logic step, in [0,1]
+    inline void setInterpolation(float t) {
+
+        interp = t;
+    }
+    // Get the interpolation factor. Animated
+    // objects draw themselves at
+    // lerp(previous, current, factor)
+    inline float getInterpolation() {
+
+        return interp;
+    }
+
+    // Set the bitmap used for filled shapes.
+    // Only its center is sampled. NULL restores
+    // the default
+    void setWhiteBitmap(Bitmap* bmp);
+
+    // Start recording quads to a mesh instead
+    // of drawing them. Recorded quads are not
+    // transformed. The queue is not drawn, so a
+    // mesh already queued this frame must not
+    // be recorded again
+    void beginMesh(Mesh* mesh);
+    // Stop recording
+    void endMesh();
+    // Draw a mesh using the active transformation
+    void drawMesh(Mesh* mesh, Color tint);
+    // Draw a mesh using the given transformation
+    void drawMesh(Mesh* mesh, Affine2 m, Color tint);
 };
 
 #endif // __GRAPHICS_CORE_H__
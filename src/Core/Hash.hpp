@@ -0,0 +1,39 @@
+// Name hashing
+// (c) 2019 Jani Nykänen
+
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include "Types.hpp"
+
+#include <string>
+#include <type_traits>
+
+// A hashed name
+typedef uint32 NameID;
+
+// FNV-1a constants
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+
+// Hash a name. Usable in constant expressions
+constexpr NameID hashName(const char* s, NameID h = FNV_OFFSET) {
+
+    return *s == 0 ? h : hashName(s+1, (h ^ (uint8)*s) * FNV_PRIME);
+}
+// Hash a name, at runtime
+inline NameID hashName(const std::string &s) {
+
+    NameID h = FNV_OFFSET;
+    for(int i = 0; i < s.length(); ++ i) {
+
+        h = (h ^ (uint8)s[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+// Hash a string literal at compile time
+#define NAME_ID(s) (std::integral_constant<NameID, hashName(s)>::value)
+
+#endif // __HASH_H__
@@ -0,0 +1,124 @@
+// Asset hot reloading
+// (c) 2019 Jani Nykänen
+
+#include "HotReload.hpp"
+
+#include "Trace.hpp"
+
+#include "../Lib/ReadPNG.hpp"
+
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+
+
+// Decode an image
+void HotReload::decode(std::string path) {
+
+    TraceScope trace("HotReload::decode", path.c_str());
+
+    ReloadImage img;
+    img.path = path;
+    img.data = NULL;
+    img.width = 0;
+    img.height = 0;
+    try {
+
+        img.data = readPNG(path, img.width, img.height);
+    }
+    catch(std::runtime_error err) {
+
+        img.error = err.what();
+    }
+
+    // A newer version replaces the one waiting
+    std::lock_guard<std::mutex> l(readyLock);
+    for(int i = 0; i < ready.size(); ++ i) {
+
+        if(ready[i].path == path) {
+
+            free(ready[i].data);
+            ready[i] = img;
+            return;
+        }
+    }
+    ready.push_back(img);
+}
+
+
+// Constructor
+HotReload::HotReload(AssetPack* assets) {
+
+    this->assets = assets;
+    pool = new ThreadPool(1);
+}
+
+
+// Destructor
+HotReload::~HotReload() {
+
+    // Wait for the decoding first
+    delete pool;
+
+    for(int i = 0; i < ready.size(); ++ i) {
+
+        free(ready[i].data);
+    }
+}
+
+
+// Check for changed files
+void HotReload::poll(std::vector<std::string> &changed) {
+
+    std::vector<std::string> files;
+    watcher.poll(files);
+
+    for(int i = 0; i < files.size(); ++ i) {
+
+        if(assets->isBitmapSource(files[i])) {
+
+            pool->submit(std::bind(&HotReload::decode, this, files[i]));
+        }
+        else {
+
+            changed.push_back(files[i]);
+        }
+    }
+}
+
+
+// Upload a decoded bitmap
+bool HotReload::uploadNext() {
+
+    ReloadImage img;
+    {
+        std::lock_guard<std::mutex> l(readyLock);
+        if(ready.empty()) return false;
+
+        img = ready.front();
+        ready.erase(ready.begin());
+    }
+
+    bool done = false;
+    if(img.error.empty()) {
+
+        try {
+
+            assets->reloadBitmap(img.path, img.data, img.width, img.height);
+            printf("Reloaded %s\n", img.path.c_str());
+            done = true;
+        }
+        catch(std::runtime_error err) {
+
+            img.error = err.what();
+        }
+    }
+    if(!done) {
+
+        printf("Warning: could not reload %s: %s\n",
+            img.path.c_str(), img.error.c_str());
+    }
+    free(img.data);
+
+    return done;
+}
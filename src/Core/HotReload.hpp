@@ -0,0 +1,74 @@
+// Asset hot reloading
+// (c) 2019 Jani Nykänen
+
+#ifndef __HOT_RELOAD_H__
+#define __HOT_RELOAD_H__
+
+#include "FileWatcher.hpp"
+#include "ThreadPool.hpp"
+#include "AssetPack.hpp"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+// A changed image, decoded
+struct ReloadImage {
+
+    std::string path;
+    // From malloc
+    uint8* data;
+    int width;
+    int height;
+    // Set if decoding failed
+    std::string error;
+};
+
+
+// Watches the asset files while the game runs.
+// Changed bitmaps are decoded on a worker thread
+// and uploaded one per frame, other changed files
+// are left to the caller
+class HotReload {
+
+private:
+
+    // Watcher
+    FileWatcher watcher;
+    // Asset pack to reload to
+    AssetPack* assets;
+
+    // Decoding thread
+    ThreadPool* pool;
+    // Images waiting for the upload
+    std::vector<ReloadImage> ready;
+    std::mutex readyLock;
+
+    // Decode an image, on the worker thread
+    void decode(std::string path);
+
+public:
+
+    // Constructor
+    HotReload(AssetPack* assets);
+    // Destructor
+    ~HotReload();
+
+    // Watch a directory, see FileWatcher::watch
+    inline bool watch(std::string dir, bool recursive = false) {
+        return watcher.watch(dir, recursive);
+    }
+
+    // Check for changed files. Bitmaps are decoded
+    // in the background, the other files are added
+    // to the list
+    void poll(std::vector<std::string> &changed);
+    // Upload a decoded bitmap, if any. Returns true if
+    // a bitmap changed. On the GL thread only
+    bool uploadNext();
+
+    // Getters
+    inline bool isEnabled() { return watcher.isEnabled(); }
+};
+
+#endif // __HOT_RELOAD_H__
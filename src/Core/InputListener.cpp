@@ -41,6 +41,7 @@ void InputListener::inputDown(std::vector<int> &arr, int index) {
         return;
 
     arr[index] = State::Pressed;
+    inputChanged = true;
 }
 
 
@@ -52,6 +53,7 @@ void InputListener::inputUp(std::vector<int> &arr, int index) {
         return;
 
     arr[index] = State::Released;
+    inputChanged = true;
 }
 
 
@@ -84,6 +86,7 @@ void InputListener::updateJoystick(float x, float y) {
 
     joystick.x = x;
     joystick.y = y;
+    inputChanged = true;
 }
 
 
@@ -114,6 +117,7 @@ InputListener::InputListener(void* window) {
     joystick.x = 0;
     joystick.y = 0;
     joyHardEnabled = true;
+    inputChanged = false;
 }
 
 
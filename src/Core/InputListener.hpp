@@ -43,6 +43,9 @@ protected:
     Point stickAxes;
     Point hatAxes;
 
+    // Has the input changed since the last check
+    bool inputChanged;
+
     // Input down
     void inputDown(std::vector<int> &arr, int index);
     // Input up
@@ -72,6 +75,13 @@ public:
     inline int getButtonState(int b) { return getInputState(joystate, b); }
     // Get joystick
     inline Vector2 getJoystick() {return joystick;}
+    // Has the input changed since the last check
+    inline bool checkInputChange() {
+
+        bool ret = inputChanged;
+        inputChanged = false;
+        return ret;
+    }
 
     // Set joy axes
     inline void setJoyAxes(Point stick, Point hat) {
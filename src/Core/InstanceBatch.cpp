@@ -0,0 +1,137 @@
+// Instance batch
+// (c) 2019 Jani Nykänen
+
+#include "InstanceBatch.hpp"
+
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+
+
+// Constructor
+InstanceBatch::InstanceBatch() {
+
+    // Unit quad
+    const float CORNERS[] = {0,0, 1,0, 1,1, 0,1};
+    const uint16 INDICES[] = {0,1,2, 2,3,0};
+
+    instances = std::vector<float> (INSTANCE_MAX*INSTANCE_SIZE);
+    count = 0;
+    texture = NULL;
+
+    // Generate buffers
+    glGenBuffers(1, &cornerBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenBuffers(1, &instanceBuffer);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CORNERS),
+        (const void*)CORNERS, GL_STATIC_DRAW);
+
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(INDICES),
+        (const void*)INDICES, GL_STATIC_DRAW);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float),
+        NULL, GL_STREAM_DRAW);
+
+    // Instance attributes advance once per
+    // instance. Nothing else uses them, so
+    // this is set only once
+    for(int i = 3; i < 8; ++ i) {
+
+        glVertexAttribDivisorARB(i, 1);
+    }
+}
+
+
+// Destructor
+InstanceBatch::~InstanceBatch() {
+
+    GLState::deleteBuffer(cornerBuffer);
+    GLState::deleteBuffer(indexBuffer);
+    GLState::deleteBuffer(instanceBuffer);
+}
+
+
+// Is instancing supported
+bool InstanceBatch::isSupported() {
+
+    // The divisors come from one extension
+    // and the draw call from another
+    return GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
+}
+
+
+// Can an instance be added without flushing
+bool InstanceBatch::canPush(Bitmap* bmp) {
+
+    return count == 0 ||
+        (count < INSTANCE_MAX &&
+         texture->getTexture() == bmp->getTexture());
+}
+
+
+// Add an instance
+void InstanceBatch::push(Bitmap* bmp, Affine2 &m, SpriteInstance &inst) {
+
+    texture = bmp;
+
+    float* out = &instances[count*INSTANCE_SIZE];
+    out[0] = m.a; out[1] = m.c; out[2] = m.tx;
+    out[3] = m.b; out[4] = m.d; out[5] = m.ty;
+    out[6] = inst.dx; out[7] = inst.dy;
+    out[8] = inst.dw; out[9] = inst.dh;
+    out[10] = inst.u1; out[11] = inst.v1;
+    out[12] = inst.u2; out[13] = inst.v2;
+    out[14] = inst.color.r; out[15] = inst.color.g;
+    out[16] = inst.color.b; out[17] = inst.color.a;
+
+    ++ count;
+}
+
+
+// Draw everything in the batch
+void InstanceBatch::flush() {
+
+    const int STRIDE = INSTANCE_SIZE * sizeof(float);
+
+    if(count == 0) return;
+
+    texture->bind();
+    GLState::enableAttribs(INSTANCE_ATTRIBS);
+
+    // Set attribute pointers
+    if(GLState::setVertexSource(cornerBuffer)) {
+
+        GLState::bindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+        glVertexAttribPointer(0, 2, GL_FLOAT, false, 0, (void*)0);
+
+        GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glVertexAttribPointer(3, 3, GL_FLOAT, false, STRIDE, (void*)0);
+        glVertexAttribPointer(4, 3, GL_FLOAT, false, STRIDE,
+            (void*)(3*sizeof(float)));
+        glVertexAttribPointer(5, 4, GL_FLOAT, false, STRIDE,
+            (void*)(6*sizeof(float)));
+        glVertexAttribPointer(6, 4, GL_FLOAT, false, STRIDE,
+            (void*)(10*sizeof(float)));
+        glVertexAttribPointer(7, 4, GL_FLOAT, false, STRIDE,
+            (void*)(14*sizeof(float)));
+    }
+
+    // Upload instances, orphaning the old storage
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float),
+        NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count*STRIDE,
+        (const void*)&instances[0]);
+
+    // Draw
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glDrawElementsInstancedARB(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT,
+        (void*)0, count);
+
+    count = 0;
+}
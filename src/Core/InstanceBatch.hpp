@@ -0,0 +1,79 @@
+// Instance batch
+// (c) 2019 Jani Nykänen
+
+#ifndef __INSTANCE_BATCH_H__
+#define __INSTANCE_BATCH_H__
+
+#include "Types.hpp"
+#include "Bitmap.hpp"
+
+#include <vector>
+
+// Floats per instance: transformation (6),
+// rectangle (4), UV (4), color (4)
+#define INSTANCE_SIZE 18
+// Vertex attributes used, as a bit mask
+#define INSTANCE_ATTRIBS 0xF9
+// Maximum amount of instances in one draw call
+#define INSTANCE_MAX 4096
+
+
+// Sprite instance
+struct SpriteInstance {
+
+    // Translation, rotation & scale
+    float x, y;
+    float angle;
+    float sx, sy;
+    // Rectangle before transforming
+    float dx, dy, dw, dh;
+    // Texture coordinates
+    float u1, v1, u2, v2;
+    // Color
+    Color color;
+};
+
+
+// Instance batch class. Draws many transformed
+// copies of a quad in one call, the transformation
+// is done in the vertex shader
+class InstanceBatch {
+
+private:
+
+    // Buffers
+    uint32 cornerBuffer;
+    uint32 indexBuffer;
+    uint32 instanceBuffer;
+
+    // Instance data
+    std::vector<float> instances;
+    // Instance count
+    int count;
+    // Active texture
+    Bitmap* texture;
+
+public:
+
+    // Constructor
+    InstanceBatch();
+    // Destructor
+    ~InstanceBatch();
+
+    // Is instancing supported
+    static bool isSupported();
+
+    // Can an instance be added without flushing
+    bool canPush(Bitmap* bmp);
+    // Add an instance, m being its complete
+    // transformation
+    void push(Bitmap* bmp, Affine2 &m, SpriteInstance &inst);
+    // Draw everything in the batch. The instanced
+    // shader must be in use
+    void flush();
+
+    // Getters
+    inline int getCount() { return count; }
+};
+
+#endif // __INSTANCE_BATCH_H__
@@ -22,4 +22,14 @@ MIN(uint16)
 MIN(int32)
 MIN(uint32)
 
+// Linear interpolation, t in [0,1]
+inline float lerp(float a, float b, float t) {
+
+    return a + (b-a) * t;
+}
+inline Vector2 lerp(Vector2 a, Vector2 b, float t) {
+
+    return Vector2(lerp(a.x, b.x, t), lerp(a.y, b.y, t));
+}
+
 #endif // __MATH_EXT_H__
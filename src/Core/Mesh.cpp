@@ -3,55 +3,164 @@
 
 #include "Mesh.hpp"
 
+#include "SpriteBatch.hpp"
+#include "GLState.hpp"
+
 #include <GL/glew.h>
 #include <GL/gl.h>
 
-// Constructor
-Mesh::Mesh(float* vertices, float* uvs, uint16* indices,
-    int vertexCount, int uvCount, int indexCount) {
 
-    // Generate buffers
-    glGenBuffers(1, &vertexBuffer);
-    glGenBuffers(1, &uvBuffer);
-    glGenBuffers(1, &indexBuffer);
+// Upload data to the GPU
+void Mesh::upload() {
+
+    // Generate buffers, if not done yet
+    if(vertexBuffer == 0) {
+
+        glGenBuffers(1, &vertexBuffer);
+        glGenBuffers(1, &indexBuffer);
+    }
+
+    // Compute indices
+    std::vector<uint32> indices (quadCount*6);
+    uint32 v;
+    for(int i = 0; i < quadCount; ++ i) {
+
+        v = (uint32)(i*4);
+        indices[i*6] = v;
+        indices[i*6 +1] = v+1;
+        indices[i*6 +2] = v+2;
+        indices[i*6 +3] = v+2;
+        indices[i*6 +4] = v+3;
+        indices[i*6 +5] = v;
+    }
 
     // Set buffers
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(float), 
-        (const void*)vertices, GL_STATIC_DRAW);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+        (const void*)&vertices[0], GL_STATIC_DRAW);
+
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32),
+        (const void*)&indices[0], GL_STATIC_DRAW);
+
+    uploaded = true;
+}
+
+
+// Constructors
+Mesh::Mesh() {
+
+    vertexBuffer = 0;
+    indexBuffer = 0;
+    uploaded = false;
+    quadCount = 0;
+}
+Mesh::Mesh(const Mesh &m) {
+
+    vertexBuffer = 0;
+    indexBuffer = 0;
+    *this = m;
+}
+
+
+// Destructor
+Mesh::~Mesh() {
+
+    if(vertexBuffer != 0) {
+
+        GLState::deleteBuffer(vertexBuffer);
+        GLState::deleteBuffer(indexBuffer);
+    }
+}
+
 
-    glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-	glBufferData(GL_ARRAY_BUFFER, uvCount * sizeof(float), 
-        (const void*)uvs, GL_STATIC_DRAW);
+// Assignment
+Mesh& Mesh::operator=(const Mesh &m) {
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint16), 
-        (const void*)indices, GL_STATIC_DRAW);  
+    // Copy the data only, the buffers
+    // are refreshed on the next draw
+    vertices = m.vertices;
+    segments = m.segments;
+    quadCount = m.quadCount;
+    uploaded = false;
 
-    this->indexCount = indexCount;
+    return *this;
 }
 
 
-// Bind
-void Mesh::bind() {
+// Remove all the quads
+void Mesh::clear() {
+
+    vertices.clear();
+    segments.clear();
+    quadCount = 0;
+    uploaded = false;
+}
+
+
+// Add a quad
+void Mesh::pushQuad(Bitmap* bmp, Vector2* corners,
+    float u1, float v1, float u2, float v2, Color col) {
+
+    // Start a new segment if the texture changes
+    if(segments.empty() ||
+       segments.back().texture->getTexture() != bmp->getTexture()) {
+
+        segments.push_back(MeshSegment(bmp, quadCount));
+    }
+    ++ segments.back().count;
+
+    float uvs[] = {u1,v1, u2,v1, u2,v2, u1,v2};
+    for(int i = 0; i < 4; ++ i) {
 
-    // Bind buffers for use
-    glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-		
-	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-	glVertexAttribPointer( 0, 2, GL_FLOAT, false, 0, (void*)0);
-		
-	glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-	glVertexAttribPointer( 1, 2, GL_FLOAT, false, 0, (void*)0);
-		
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        vertices.push_back(corners[i].x);
+        vertices.push_back(corners[i].y);
+        vertices.push_back(uvs[i*2]);
+        vertices.push_back(uvs[i*2 +1]);
+        vertices.push_back(col.r);
+        vertices.push_back(col.g);
+        vertices.push_back(col.b);
+        vertices.push_back(col.a);
+    }
+
+    ++ quadCount;
+    uploaded = false;
 }
 
 
 // Draw
 void Mesh::draw() {
 
-    glDrawElements(GL_TRIANGLES, indexCount, 
-        GL_UNSIGNED_SHORT, (void*)0);
+    const int STRIDE = BATCH_VERTEX_SIZE * sizeof(float);
+
+    if(quadCount == 0) return;
+
+    if(!uploaded) {
+
+        upload();
+    }
+
+    // Bind buffers
+    GLState::enableAttribs(BATCH_ATTRIBS);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    if(GLState::setVertexSource(vertexBuffer)) {
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, false, STRIDE, (void*)0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, false, STRIDE,
+            (void*)(2*sizeof(float)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, false, STRIDE,
+            (void*)(4*sizeof(float)));
+    }
+
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    // Draw segments
+    MeshSegment s;
+    for(int i = 0; i < segments.size(); ++ i) {
+
+        s = segments[i];
+        s.texture->bind();
+        glDrawElements(GL_TRIANGLES, s.count*6, GL_UNSIGNED_INT,
+            (void*)(s.first*6*sizeof(uint32)));
+    }
 }
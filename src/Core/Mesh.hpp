@@ -5,29 +5,74 @@
 #define __MESH_H__
 
 #include "Types.hpp"
+#include "Bitmap.hpp"
 
-// Mesh type
+#include <vector>
+
+// A range of quads using the same texture
+struct MeshSegment {
+
+    Bitmap* texture;
+    int first;
+    int count;
+
+    // Constructor
+    inline MeshSegment(Bitmap* texture = NULL, int first = 0) {
+
+        this->texture = texture;
+        this->first = first;
+        count = 0;
+    }
+};
+
+
+// Mesh type. Stores quads in the same vertex
+// format as the sprite batch, but uploads them
+// only once
 class Mesh {
 
 private:
 
     // Buffers
     uint32 vertexBuffer;
-    uint32 uvBuffer;
     uint32 indexBuffer;
-    uint32 indexCount;
+    // Are the buffers up to date
+    bool uploaded;
+
+    // Vertex data
+    std::vector<float> vertices;
+    // Segments
+    std::vector<MeshSegment> segments;
+    // Quad count
+    int quadCount;
+
+    // Upload data to the GPU
+    void upload();
 
 public:
 
-    // Constructor
-    Mesh(float* vertices, float* uvs, uint16* indices,
-        int vertexCount, int uvCount, int indexCount);
+    // Constructors
+    Mesh();
+    Mesh(const Mesh &m);
+    // Destructor
+    ~Mesh();
+
+    // Assignment (GPU buffers are not shared)
+    Mesh& operator=(const Mesh &m);
 
-    // Bind
-    void bind();
+    // Remove all the quads
+    void clear();
+    // Add a quad. Corners are given in the order
+    // top-left, top-right, bottom-right, bottom-left
+    void pushQuad(Bitmap* bmp, Vector2* corners,
+        float u1, float v1, float u2, float v2, Color col);
 
     // Draw
     void draw();
+
+    // Getters
+    inline int getQuadCount() { return quadCount; }
+    inline int getSegmentCount() { return (int)segments.size(); }
 };
 
 #endif // __MESH_H__
@@ -3,16 +3,21 @@
 
 #include "Music.hpp"
 
-#include "MathExt.hpp"
+#include <cstdio>
 
 
-// Constructor
+// Constructors
 Music::Music(std::string path) {
 
     loaded = false;
+    track = NULL;
 
-    // Load
-    track = Mix_LoadMUS(path.c_str());
+    // Nothing is loaded without audio
+    if(Mix_QuerySpec(NULL, NULL, NULL) == 0)
+        return;
+
+    // Decode
+    track = Mix_LoadWAV(path.c_str());
     if(track == NULL) {
 
         printf("Failed to load a music track in %s. Ignoring.\n",
@@ -21,35 +26,39 @@ Music::Music(std::string path) {
     }
     loaded = true;
 }
+Music::Music(const void* mem, int size, std::string path) {
 
+    load(mem, size, path);
+}
 
-// Play
-void Music::play(float vol, bool loop) {
-
-    if(!loaded) return;
 
-    int v = max_int32(0, 
-        min_int32(
-            (int)(vol*MIX_MAX_VOLUME), 
-            MIX_MAX_VOLUME)
-        );
+// Destructor
+Music::~Music() {
 
-    Mix_VolumeMusic(v);
-    Mix_PlayMusic(track, loop ? -1 : 0);
+    if(track != NULL)
+        Mix_FreeChunk(track);
 }
 
 
-// Fade in
-void Music::fadeIn(float vol, int time, bool loop) {
+// Decode the track from memory
+void Music::load(const void* mem, int size, std::string path) {
 
-    if(!loaded) return;
+    loaded = false;
+    track = NULL;
+
+    // Nothing is loaded without audio
+    if(Mix_QuerySpec(NULL, NULL, NULL) == 0)
+        return;
 
-    int v = max_int32(0, 
-        min_int32(
-            (int)(vol*MIX_MAX_VOLUME), 
-            MIX_MAX_VOLUME)
-        );
+    if(size > 0) {
 
-    Mix_VolumeMusic(v);
-    Mix_FadeInMusic(track, loop ? -1 : 0, time);
+        track = Mix_LoadWAV_RW(SDL_RWFromConstMem(mem, size), 1);
+    }
+    if(track == NULL) {
+
+        printf("Failed to load a music track in %s. Ignoring.\n",
+            path.c_str());
+        return;
+    }
+    loaded = true;
 }
@@ -8,29 +8,41 @@
 
 #include <string>
 
+#include "Types.hpp"
 
-// Music track type
+
+// Music track type. The track is decoded completely
+// when loaded, so that the mixer can play it without
+// reading any files
 class Music {
 
 private:
 
-    // Music track
-    Mix_Music* track;
+    // Decoded track, in the mixer format
+    Mix_Chunk* track;
 
     // Is successfully loaded
     bool loaded;
 
+    // Decode the track from memory
+    void load(const void* mem, int size, std::string path);
+
 public:
 
-    // Constructor
+    // Constructors
     Music(std::string path);
-
-    // Play
-    void play(float vol, bool loop=true);
-    // Fade in
-    void fadeIn(float vol, int time=1000, bool loop=true);
-    // Stop
-    void stop();
+    // Decode from memory. The path is only
+    // used for error messages
+    Music(const void* mem, int size, std::string path);
+    // Destructor
+    ~Music();
+
+    // Getters
+    inline bool isLoaded() { return loaded; }
+    // 16-bit PCM in the mixer format
+    inline const int16* getData() { return (const int16*)track->abuf; }
+    // Size in bytes
+    inline int getSize() { return (int)track->alen; }
 };
 
 
@@ -0,0 +1,263 @@
+// Asset packer
+// (c) 2019 Jani Nykänen
+
+#include "Packer.hpp"
+
+#include "AssetPack.hpp"
+#include "Config.hpp"
+#include "AudioManager.hpp"
+#include "Utility.hpp"
+
+#include "../Lib/ReadPNG.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+
+// Tilemap file extension
+static const std::string TILEMAP_EXT = ".tmx";
+
+
+// Find the tilemaps in a directory
+void Packer::findTilemaps(std::string dir, std::string sub,
+    std::vector<std::string> &out) {
+
+    DIR* d = opendir((dir + sub).c_str());
+    if(d == NULL) return;
+
+    std::string name, path;
+    struct stat st;
+    struct dirent* e;
+    while((e = readdir(d)) != NULL) {
+
+        name = std::string(e->d_name);
+        if(name[0] == '.') continue;
+
+        path = sub + name;
+        if(stat((dir + path).c_str(), &st) != 0) continue;
+
+        if(S_ISDIR(st.st_mode)) {
+
+            findTilemaps(dir, path + "/", out);
+        }
+        else if(name.length() > TILEMAP_EXT.length() &&
+            name.compare(name.length() - TILEMAP_EXT.length(),
+                TILEMAP_EXT.length(), TILEMAP_EXT) == 0) {
+
+            out.push_back(path);
+        }
+    }
+    closedir(d);
+}
+
+
+// Pack
+void Packer::pack(std::string configPath, std::string mapPath,
+    std::string outPath) {
+
+    ArchiveWriter out;
+    ConfigData data = ConfigData(configPath);
+
+    // Samples are converted by the mixer, so it is
+    // opened in the format the game asks for. No
+    // sound is played, so no device is needed
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    int freq = 0, channels = 0;
+    Uint16 format = 0;
+    if(SDL_Init(SDL_INIT_AUDIO) == 0 &&
+       Mix_OpenAudio(AUDIO_FREQUENCY, MIX_DEFAULT_FORMAT,
+            AUDIO_CHANNELS, AUDIO_CHUNK_SIZE) == 0) {
+
+        Mix_QuerySpec(&freq, &format, &channels);
+    }
+    else {
+
+        printf("Warning: could not open audio, samples are "
+            "stored as they are\n");
+    }
+
+    // Go through the assets
+    Atlas atlas(ATLAS_MAX_PAGE_SIZE);
+    std::vector<std::string> atlasNames;
+    std::string basePath;
+    int type = AssetType::Bitmap;
+    bool useAtlas = false;
+    int bitmapFormat = BitmapFormat::RGBA8;
+    bool mipmap = false;
+    int priority = 0;
+
+    std::string key, value, path;
+    std::vector<uint8> bytes;
+    uint8* pixels;
+    int w, h;
+    Mix_Chunk* chunk;
+    for(int i = 0; i < data.getParamCount(); ++ i) {
+
+        key = data.getKey(i);
+        value = data.getParam(i);
+
+        // Special parameters, as in AssetPack
+        if(key[0] == '@') {
+
+            key = key.substr(1);
+            if(key == "path")
+                basePath = value;
+            else if(key == "type")
+                type = value == "sample" ? AssetType::Sample :
+                    (value == "music" ? AssetType::Music : 
+                        AssetType::Bitmap);
+            else if(key == "atlas")
+                useAtlas = value == "1";
+            else if(key == "format")
+                bitmapFormat = Bitmap::parseFormat(value);
+            else if(key == "mipmap")
+                mipmap = value == "1";
+            else if(key == "priority")
+                priority = strToInt(value);
+
+            continue;
+        }
+        path = basePath + value;
+
+        switch(type) {
+
+        case AssetType::Bitmap:
+            pixels = readPNG(path, w, h);
+            if(useAtlas) {
+
+                atlas.add(pixels, w, h, bitmapFormat);
+                atlasNames.push_back(key);
+            }
+            else {
+
+                out.add(ArchiveType::Bitmap, key, pixels, w*h*4, w, h,
+                    bitmapFormat, mipmap ? 1 : 0);
+                free(pixels);
+            }
+            break;
+
+        case AssetType::Sample:
+            chunk = freq == 0 ? NULL : Mix_LoadWAV(path.c_str());
+            if(chunk != NULL) {
+
+                out.add(ArchiveType::Sample, key, chunk->abuf, chunk->alen,
+                    freq, format, channels, priority);
+                Mix_FreeChunk(chunk);
+            }
+            else {
+
+                if(!readFile(path, bytes))
+                    throw std::runtime_error("Failed to read " + path);
+
+                out.add(ArchiveType::Sample, key,
+                    bytes.empty() ? NULL : &bytes[0], bytes.size(),
+                    0, 0, 0, priority);
+            }
+            break;
+
+        case AssetType::Music:
+            if(!readFile(path, bytes))
+                throw std::runtime_error("Failed to read " + path);
+
+            out.add(ArchiveType::Music, key,
+                bytes.empty() ? NULL : &bytes[0], bytes.size());
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Pack the atlas
+    if(!atlasNames.empty()) {
+
+        std::vector<AtlasPage> pages;
+        std::vector<AtlasRegion> regions;
+        atlas.pack(pages, regions);
+
+        AtlasPage* p;
+        for(int i = 0; i < pages.size(); ++ i) {
+
+            p = &pages[i];
+            out.add(ArchiveType::AtlasPage, "@page" + intToString(i),
+                p->data, p->width*p->height*4, p->width, p->height,
+                p->format);
+            free(p->data);
+        }
+
+        // The white region is the last one
+        AtlasRegion* r;
+        for(int i = 0; i < regions.size(); ++ i) {
+
+            r = &regions[i];
+            out.add(ArchiveType::AtlasRegion,
+                i < atlasNames.size() ? atlasNames[i] : "@white", NULL, 0,
+                r->page, r->x, r->y, r->width, r->height);
+        }
+    }
+
+    // Tilemaps, named by their path without
+    // the extension
+    std::vector<std::string> maps;
+    findTilemaps(mapPath, "", maps);
+    std::sort(maps.begin(), maps.end());
+    for(int i = 0; i < maps.size(); ++ i) {
+
+        bytes.clear();
+        Tilemap(mapPath + maps[i]).serialize(bytes);
+        out.add(ArchiveType::Tilemap,
+            maps[i].substr(0, maps[i].length() - TILEMAP_EXT.length()),
+            &bytes[0], bytes.size());
+    }
+
+    if(freq != 0) {
+
+        Mix_CloseAudio();
+    }
+    SDL_Quit();
+
+    if(!out.write(outPath)) {
+
+        throw std::runtime_error("Failed to write the archive " + outPath);
+    }
+    printf("Packed %d entries to %s\n", out.getEntryCount(),
+        outPath.c_str());
+}
+
+
+// Compile the TMX files to stage files
+void Packer::compileMaps(std::string mapPath) {
+
+    std::vector<std::string> maps;
+    findTilemaps(mapPath, "", maps);
+    std::sort(maps.begin(), maps.end());
+
+    std::string path;
+    std::vector<uint8> bytes;
+    FILE* f;
+    for(int i = 0; i < maps.size(); ++ i) {
+
+        bytes.clear();
+        Tilemap(mapPath + maps[i]).serialize(bytes);
+
+        path = mapPath + maps[i].substr(0, 
+            maps[i].length() - TILEMAP_EXT.length()) + ".stage";
+        f = fopen(path.c_str(), "wb");
+        if(f == NULL || fwrite(&bytes[0], 1, bytes.size(), f) 
+            != bytes.size()) {
+
+            if(f != NULL) fclose(f);
+            throw std::runtime_error("Failed to write " + path);
+        }
+        fclose(f);
+    }
+    printf("Compiled %d stages in %s\n", (int)maps.size(), 
+        mapPath.c_str());
+}
@@ -0,0 +1,36 @@
+// Asset packer
+// (c) 2019 Jani Nykänen
+
+#ifndef __PACKER_H__
+#define __PACKER_H__
+
+#include "Archive.hpp"
+
+#include <string>
+#include <vector>
+
+// Builds an archive of the assets listed in an
+// asset config file and of the tilemaps in a
+// directory. Images are stored decoded and atlases
+// packed, samples in the mixer format and tilemaps
+// in their binary form. Needs no window or GL
+class Packer {
+
+private:
+
+    // Find the tilemaps in a directory & its
+    // subdirectories, as paths relative to it
+    static void findTilemaps(std::string dir, std::string sub,
+        std::vector<std::string> &out);
+
+public:
+
+    // Pack. Throws on errors
+    static void pack(std::string configPath, std::string mapPath,
+        std::string outPath);
+    // Compile the TMX files in a directory & its
+    // subdirectories to stage files next to them
+    static void compileMaps(std::string mapPath);
+};
+
+#endif // __PACKER_H__
@@ -0,0 +1,236 @@
+// Profiler
+// (c) 2019 Jani Nykänen
+
+#include "Profiler.hpp"
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+
+
+// Static members
+bool Profiler::enabled = false;
+std::thread::id Profiler::owner;
+bool Profiler::gpuTimes = false;
+std::vector<ProfileSample> Profiler::frames[PROFILER_FRAMES];
+int Profiler::sampleCount[PROFILER_FRAMES] = {0};
+int Profiler::current = 0;
+int Profiler::recorded = 0;
+std::vector<int> Profiler::stack;
+std::vector<uint32> Profiler::queries[PROFILER_QUERY_SETS];
+int Profiler::queryCount[PROFILER_QUERY_SETS] = {0};
+int Profiler::querySet = 0;
+
+
+// Get a query of the active set
+int Profiler::getQuery() {
+
+    std::vector<uint32> &q = queries[querySet];
+    if(queryCount[querySet] >= (int)q.size()) {
+
+        uint32 id;
+        glGenQueries(1, &id);
+        q.push_back(id);
+    }
+    return queryCount[querySet] ++;
+}
+
+
+// Read the GPU times of a frame
+void Profiler::readGPUTimes(int frame, int set) {
+
+    if(queryCount[set] == 0)
+        return;
+
+    std::vector<uint32> &q = queries[set];
+
+    // Never wait for the GPU, skip the frame
+    // instead if it is not done yet
+    int avail = 0;
+    glGetQueryObjectiv(q[queryCount[set]-1], 
+        GL_QUERY_RESULT_AVAILABLE, &avail);
+    if(avail == 0)
+        return;
+
+    GLuint64 start, end;
+    ProfileSample* s;
+    for(int i = 0; i < sampleCount[frame]; ++ i) {
+
+        s = &frames[frame][i];
+        if(s->queryStart < 0 || s->queryEnd < 0)
+            continue;
+
+        glGetQueryObjectui64v(q[s->queryStart], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(q[s->queryEnd], GL_QUERY_RESULT, &end);
+        s->gpu = (float)((end - start) / 1000000.0);
+    }
+}
+
+
+// Enable the profiler
+void Profiler::enable() {
+
+    enabled = true;
+    owner = std::this_thread::get_id();
+    // Timestamps can be nested, unlike
+    // GL_TIME_ELAPSED queries
+    gpuTimes = GLEW_ARB_timer_query;
+}
+
+
+// Free the queries
+void Profiler::disable() {
+
+    for(int i = 0; i < PROFILER_QUERY_SETS; ++ i) {
+
+        if(queries[i].size() > 0)
+            glDeleteQueries((int)queries[i].size(), &queries[i][0]);
+
+        queries[i].clear();
+        queryCount[i] = 0;
+    }
+    enabled = false;
+}
+
+
+// Start a scope
+void Profiler::begin(const char* name) {
+
+    if(!enabled || std::this_thread::get_id() != owner) return;
+
+    std::vector<ProfileSample> &f = frames[current];
+    if(sampleCount[current] >= (int)f.size())
+        f.resize(f.size()+1);
+
+    ProfileSample &s = f[sampleCount[current]];
+    s.name = name;
+    s.depth = (int)stack.size();
+    s.cpu = 0.0f;
+    s.gpu = -1.0f;
+    s.queryStart = -1;
+    s.queryEnd = -1;
+
+    stack.push_back(sampleCount[current] ++);
+
+    if(gpuTimes) {
+
+        s.queryStart = getQuery();
+        glQueryCounter(queries[querySet][s.queryStart], GL_TIMESTAMP);
+    }
+    s.cpuStart = glfwGetTime();
+}
+
+
+// End the innermost scope
+void Profiler::end() {
+
+    if(!enabled || stack.size() == 0 || 
+        std::this_thread::get_id() != owner) return;
+
+    ProfileSample &s = frames[current][stack.back()];
+    stack.pop_back();
+
+    if(gpuTimes) {
+
+        s.queryEnd = getQuery();
+        glQueryCounter(queries[querySet][s.queryEnd], GL_TIMESTAMP);
+    }
+    s.cpu = (float)((glfwGetTime() - s.cpuStart) * 1000.0);
+}
+
+
+// Finish the current frame
+void Profiler::endFrame() {
+
+    if(!enabled) return;
+
+    // Scopes left open are dropped
+    stack.clear();
+    ++ recorded;
+
+    // Read the oldest query set before it is
+    // used again
+    int next = (querySet+1) % PROFILER_QUERY_SETS;
+    int frame = (current - (PROFILER_QUERY_SETS-1) + PROFILER_FRAMES) 
+        % PROFILER_FRAMES;
+    if(gpuTimes && recorded >= PROFILER_QUERY_SETS) {
+
+        readGPUTimes(frame, next);
+    }
+    querySet = next;
+    queryCount[querySet] = 0;
+
+    current = (current+1) % PROFILER_FRAMES;
+    sampleCount[current] = 0;
+}
+
+
+// Get a finished frame
+int Profiler::getFrame(int age, ProfileSample* &samples) {
+
+    if(age < 0 || age >= recorded || age >= PROFILER_FRAMES-1)
+        return -1;
+
+    int i = (current - 1 - age + PROFILER_FRAMES) % PROFILER_FRAMES;
+    samples = sampleCount[i] > 0 ? &frames[i][0] : NULL;
+
+    return sampleCount[i];
+}
+
+
+// Average times of a scope
+void Profiler::getAverage(const std::string &name, 
+    float &cpu, float &gpu) {
+
+    cpu = 0.0f;
+    gpu = 0.0f;
+
+    ProfileSample* samples;
+    int count;
+    int cpuFrames = 0;
+    int gpuFrames = 0;
+    bool found;
+    bool gpuKnown;
+    for(int age = 0; (count = getFrame(age, samples)) >= 0; ++ age) {
+
+        found = false;
+        gpuKnown = true;
+        for(int i = 0; i < count; ++ i) {
+
+            if(samples[i].name != name)
+                continue;
+
+            found = true;
+            cpu += samples[i].cpu;
+            if(samples[i].gpu >= 0.0f)
+                gpu += samples[i].gpu;
+            else
+                gpuKnown = false;
+        }
+        if(!found) continue;
+
+        ++ cpuFrames;
+        if(gpuKnown) ++ gpuFrames;
+    }
+
+    cpu = cpuFrames > 0 ? cpu / cpuFrames : 0.0f;
+    gpu = gpuFrames > 0 ? gpu / gpuFrames : -1.0f;
+}
+
+
+// Print the latest frame with known GPU times
+void Profiler::print() {
+
+    ProfileSample* samples;
+    int count = getFrame(gpuTimes ? PROFILER_QUERY_SETS-1 : 0, samples);
+    if(count < 0) return;
+
+    printf("Profile (ms, CPU / GPU):\n");
+    for(int i = 0; i < count; ++ i) {
+
+        printf("%*s%s: %.3f / %.3f\n", samples[i].depth*2 + 2, "",
+            samples[i].name.c_str(), samples[i].cpu, samples[i].gpu);
+    }
+}
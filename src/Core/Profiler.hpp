@@ -0,0 +1,118 @@
+// Profiler
+// (c) 2019 Jani Nykänen
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "Types.hpp"
+
+#include <vector>
+#include <string>
+#include <thread>
+
+// Frames kept in the ring buffer
+#define PROFILER_FRAMES 120
+// Query sets in flight. GPU times of a frame are
+// read when the frame after it ends
+#define PROFILER_QUERY_SETS 2
+
+// A timed scope
+struct ProfileSample {
+
+    // Name
+    std::string name;
+    // Nesting depth, 0 for the outermost
+    int depth;
+    // Times in milliseconds. GPU time is
+    // negative if not (yet) known
+    float cpu;
+    float gpu;
+
+    // Timestamps
+    double cpuStart;
+    int queryStart;
+    int queryEnd;
+};
+
+
+// Profiler. Records CPU and GPU time of named,
+// nestable scopes. Does nothing unless enabled
+class Profiler {
+
+private:
+
+    // Is enabled
+    static bool enabled;
+    // The thread that is timed
+    static std::thread::id owner;
+    // Are GPU times measured
+    static bool gpuTimes;
+
+    // Frames, the current one included
+    static std::vector<ProfileSample> frames[PROFILER_FRAMES];
+    static int sampleCount[PROFILER_FRAMES];
+    static int current;
+    static int recorded;
+    // Open scopes
+    static std::vector<int> stack;
+
+    // Timestamp queries, per set
+    static std::vector<uint32> queries[PROFILER_QUERY_SETS];
+    static int queryCount[PROFILER_QUERY_SETS];
+    static int querySet;
+
+    // Get a query of the active set
+    static int getQuery();
+    // Read the GPU times of a frame
+    static void readGPUTimes(int frame, int set);
+
+public:
+
+    // Enable the profiler. GPU times are measured
+    // if timer queries are supported. Only the calling
+    // thread is timed, scopes on others are ignored.
+    // Draws are queued until the end of the frame, so
+    // their GPU time goes to the scope around that
+    static void enable();
+    // Free the queries
+    static void disable();
+
+    // Start a scope
+    static void begin(const char* name);
+    // End the innermost scope
+    static void end();
+
+    // Finish the current frame
+    static void endFrame();
+
+    // Get a finished frame, 0 being the latest. Returns
+    // the number of samples, or -1 if not recorded
+    static int getFrame(int age, ProfileSample* &samples);
+    // Average times of a scope over the recorded frames
+    static void getAverage(const std::string &name, 
+        float &cpu, float &gpu);
+    // Print the latest frame with known GPU times
+    static void print();
+
+    // Getters
+    inline static bool isEnabled() { return enabled; }
+    inline static int getRecorded() { return recorded; }
+};
+
+
+// Times the scope it is created in
+class ProfileScope {
+
+public:
+
+    inline ProfileScope(const char* name) { 
+        
+        Profiler::begin(name); 
+    }
+    inline ~ProfileScope() { 
+        
+        Profiler::end(); 
+    }
+};
+
+#endif // __PROFILER_H__
@@ -0,0 +1,65 @@
+// Render queue
+// (c) 2019 Jani Nykänen
+
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+
+
+// Constructor
+RenderQueue::RenderQueue() {
+
+    layer = DrawLayer::Default;
+    ordered = true;
+}
+
+
+// Set the layer
+void RenderQueue::setLayer(int layer, bool ordered) {
+
+    this->layer = layer & 0xFF;
+    this->ordered = ordered;
+}
+
+
+// Add a command
+RenderCommand* RenderQueue::push(int kind, Bitmap* bmp) {
+
+    uint64 index = (uint64)keys.size();
+    if(index >= (uint64)commands.size())
+        commands.resize(index+1);
+
+    // Within an unordered layer, commands of the 
+    // same type and texture end up next to each
+    // other. The index keeps the sort stable
+    uint64 group = 0;
+    if(!ordered) {
+
+        group = ((uint64)kind << 29) | 
+            (bmp == NULL ? 0 : (bmp->getTexture() & 0x1FFFFFFF));
+    }
+    keys.push_back(((uint64)layer << 56) | 
+        (group << RENDER_QUEUE_SEQ_BITS) | index);
+
+    RenderCommand* c = &commands[index];
+    c->kind = kind;
+    c->bmp = bmp;
+    c->mesh = NULL;
+
+    return c;
+}
+
+
+// Sort the commands
+void RenderQueue::sort() {
+
+    std::sort(keys.begin(), keys.end());
+}
+
+
+// Remove the commands
+void RenderQueue::clear() {
+
+    // Storage is kept for the next frame
+    keys.clear();
+}
@@ -0,0 +1,103 @@
+// Render queue
+// (c) 2019 Jani Nykänen
+
+#ifndef __RENDER_QUEUE_H__
+#define __RENDER_QUEUE_H__
+
+#include "Types.hpp"
+#include "Bitmap.hpp"
+#include "Mesh.hpp"
+#include "InstanceBatch.hpp"
+
+#include <vector>
+
+// Bits of the sort key used for the
+// submission order
+#define RENDER_QUEUE_SEQ_BITS 24
+// Maximum amount of commands before the
+// queue must be drawn
+#define RENDER_QUEUE_MAX (1 << RENDER_QUEUE_SEQ_BITS)
+
+// Layers. Lower ones are drawn first
+namespace DrawLayer {
+
+    enum {
+
+        Background = 0,
+        Default = 64,
+        Foreground = 128,
+        Overlay = 192,
+    };
+}
+
+// Command types
+namespace RenderKind {
+
+    enum {
+
+        Quad = 0,
+        Instance = 1,
+        Mesh = 2,
+    };
+}
+
+
+// A queued draw
+struct RenderCommand {
+
+    int kind;
+    // Texture, NULL for meshes
+    Bitmap* bmp;
+    // Mesh, if any
+    Mesh* mesh;
+    // Complete transformation
+    Affine2 m;
+    // Rectangle, UV & color. The color is
+    // the tint of a mesh
+    SpriteInstance inst;
+};
+
+
+// Render queue class. Commands are sorted by layer.
+// Inside an ordered layer they keep the submission
+// order (for translucent or overlapping things), an
+// unordered layer groups them by type & texture
+class RenderQueue {
+
+private:
+
+    // Commands in submission order
+    std::vector<RenderCommand> commands;
+    // Sort keys: layer, group & index
+    std::vector<uint64> keys;
+    // Active layer
+    int layer;
+    bool ordered;
+
+public:
+
+    // Constructor
+    RenderQueue();
+
+    // Set the layer for the upcoming commands
+    void setLayer(int layer, bool ordered = true);
+    // Add a command. Returns the command to be filled
+    RenderCommand* push(int kind, Bitmap* bmp);
+    // Sort the commands
+    void sort();
+    // Remove the commands, the layer is kept
+    void clear();
+
+    // Get the i-th command in sorted order
+    inline RenderCommand* get(int i) {
+
+        return &commands[keys[i] & (RENDER_QUEUE_MAX-1)];
+    }
+
+    // Getters
+    inline int getCount() { return (int)keys.size(); }
+    inline bool isFull() { return keys.size() >= RENDER_QUEUE_MAX; }
+    inline int getLayer() { return layer; }
+};
+
+#endif // __RENDER_QUEUE_H__
@@ -0,0 +1,61 @@
+// Ring buffer
+// (c) 2019 Jani Nykänen
+
+#ifndef __RING_BUFFER_H__
+#define __RING_BUFFER_H__
+
+#include <atomic>
+
+// Lock-free queue of a fixed size for passing items
+// from one writer thread to one reader thread.
+// Neither side ever waits. The size must be a
+// power of two
+template <class T, int N> class RingBuffer {
+
+private:
+
+    // Slots
+    T slots[N];
+    // Items pushed & popped so far. Only the
+    // writer moves the tail & the reader the head
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+
+public:
+
+    // Constructor
+    inline RingBuffer() {
+
+        static_assert((N & (N-1)) == 0,
+            "Ring buffer size must be a power of two");
+
+        head = 0;
+        tail = 0;
+    }
+
+    // Add an item. Returns false if full
+    inline bool push(const T& item) {
+
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        if(t - head.load(std::memory_order_acquire) == N)
+            return false;
+
+        slots[t & (N-1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Take the oldest item. Returns false if empty
+    inline bool pop(T& item) {
+
+        unsigned int h = head.load(std::memory_order_relaxed);
+        if(h == tail.load(std::memory_order_acquire))
+            return false;
+
+        item = slots[h & (N-1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif // __RING_BUFFER_H__
@@ -0,0 +1,38 @@
+// SDL audio driver
+// (c) 2019 Jani Nykänen
+
+#include "SDLAudioDriver.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+
+
+// Mix on the audio thread, after SDL_mixer
+// has mixed its channels, which are not used
+static void postMix(void* udata, Uint8* stream, int len) {
+
+    AudioMixer* mixer = (AudioMixer*)udata;
+    mixer->mix((int16*)stream, 
+        len / (sizeof(int16) * mixer->getChannels()));
+}
+
+
+// Open the device
+bool SDLAudioDriver::open() {
+
+    if(!openMixer())
+        return false;
+
+    Mix_SetPostMix(postMix, mixer);
+    return true;
+}
+
+
+// Stop mixing
+void SDLAudioDriver::close() {
+
+    if(mixer == NULL) return;
+
+    // Waits for the callback to finish
+    Mix_SetPostMix(NULL, NULL);
+}
@@ -0,0 +1,25 @@
+// SDL audio driver
+// (c) 2019 Jani Nykänen
+
+#ifndef __SDL_AUDIO_DRIVER_H__
+#define __SDL_AUDIO_DRIVER_H__
+
+#include "AudioDriver.hpp"
+
+
+// Plays through the audio device, mixing
+// on the SDL audio thread
+class SDLAudioDriver : public AudioDriver {
+
+public:
+
+    // Open the device
+    bool open();
+    // Stop mixing
+    void close();
+
+    // Getters
+    inline const char* getName() { return "sdl"; }
+};
+
+#endif // __SDL_AUDIO_DRIVER_H__
@@ -7,63 +7,99 @@
 #include "MathExt.hpp"
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 
-// Constructor
+// Constructors
 Sample::Sample(std::string path) {
 
+    pcm = NULL;
+    priority = 0;
+    chunk = NULL;
+    loaded = false;
+
+    // Nothing is loaded without audio
+    if(Mix_QuerySpec(NULL, NULL, NULL) == 0)
+        return;
+
     // Load chunk
     chunk = Mix_LoadWAV(path.c_str());
-    if(chunk == NULL) {
+    loaded = chunk != NULL;
+    if(!loaded) {
 
         printf("Failed to load a WAV file in %s. Ignoring.\n", path.c_str());
-        loaded = false;
     }
-    loaded = true;
 }
+Sample::Sample(const uint8* mem, int size,
+    int frequency, int format, int channels, std::string name) {
 
+    pcm = NULL;
+    chunk = NULL;
+    loaded = false;
+    priority = 0;
 
-// Destructor
-Sample::~Sample() {
-
-    // TODO: Destroy chunk?
-}
-
-
-// Play
-void Sample::play(float vol, int loops) {
-
-    // Restrict to integers in [0,128]
-    int v =  max_int32(0, 
-        min_int32(
-            (int)(vol*MIX_MAX_VOLUME), 
-            MIX_MAX_VOLUME)
-        );
+    // Nothing is loaded without audio
+    if(Mix_QuerySpec(NULL, NULL, NULL) == 0)
+        return;
 
-    if(!played) {
+    // A sound file
+    if(frequency == 0) {
 
-        // Get channel
-        channel = Mix_PlayChannel(-1, chunk, 0);
-        Mix_HaltChannel(channel);
-
-        // Play sound
-        Mix_Volume(channel, v);
-        Mix_PlayChannel(channel, chunk, loops);
-
-        played = true;
+        chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(mem, size), 1);
     }
     else {
 
-        // Stop & play again
-        Mix_HaltChannel(channel);
-        Mix_Volume(channel, v);
-        Mix_PlayChannel(channel, chunk, loops);
+        int mixFreq, mixChannels;
+        Uint16 mixFormat;
+        Mix_QuerySpec(&mixFreq, &mixFormat, &mixChannels);
+
+        // Already in the mixer format
+        if(mixFreq == frequency && mixFormat == format &&
+           mixChannels == channels) {
+
+            chunk = Mix_QuickLoad_RAW((Uint8*)mem, size);
+        }
+        // Convert to it
+        else {
+
+            SDL_AudioCVT cvt;
+            if(SDL_BuildAudioCVT(&cvt, format, channels, frequency,
+                mixFormat, mixChannels, mixFreq) >= 0) {
+
+                cvt.len = size;
+                cvt.buf = (Uint8*)malloc(size * cvt.len_mult);
+                memcpy(cvt.buf, mem, size);
+                if(SDL_ConvertAudio(&cvt) == 0) {
+
+                    pcm = cvt.buf;
+                    chunk = Mix_QuickLoad_RAW(pcm, cvt.len_cvt);
+                }
+                else {
+
+                    free(cvt.buf);
+                }
+            }
+        }
+    }
+
+    if(chunk == NULL) {
+
+        printf("Failed to load a sample %s. Ignoring.\n", name.c_str());
+        return;
     }
+    loaded = true;
 }
 
 
-// Stop sample
-void Sample::stop() {
+// Destructor
+Sample::~Sample() {
+
+    // A chunk made from raw data does not own
+    // the data, so the converted data is freed
+    // separately
+    if(chunk != NULL)
+        Mix_FreeChunk(chunk);
+    free(pcm);
+}
 
-    Mix_HaltChannel(channel);
-}   
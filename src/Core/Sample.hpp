@@ -9,6 +9,8 @@
 
 #include <string>
 
+#include "Types.hpp"
+
 // Sample class
 class Sample {
 
@@ -16,24 +18,41 @@ private:
 
     // Info needed for playing the sample
     Mix_Chunk* chunk;
-    int channel;
-    // Has the sample been played once
-    bool played;
     // Successfully loaded
     bool loaded;
+    // Samples of a lower priority are cut first
+    // when all the voices are in use
+    int priority;
+    // Converted PCM data, if the sample
+    // owns its data
+    uint8* pcm;
 
 public:
 
     // Constructors
-    inline Sample() {};
+    inline Sample() { pcm = NULL; chunk = NULL; loaded = false; priority = 0; };
     Sample(std::string path);
+    // From PCM data in the given format. If it is the
+    // format of the mixer, the data is played from
+    // where it is and must stay valid as long as the
+    // sample exists. With frequency 0, the data is a
+    // sound file instead. The name is only used for
+    // error messages
+    Sample(const uint8* mem, int size, 
+        int frequency, int format, int channels, std::string name);
     // Destructor
     ~Sample();
 
-    // Play
-    void play(float vol, int loops=0);
-    // Stop sample
-    void stop();
+    // Set priority
+    inline void setPriority(int p) { priority = p; }
+
+    // Getters
+    inline bool isLoaded() { return loaded; }
+    inline int getPriority() { return priority; }
+    // 16-bit PCM in the mixer format
+    inline const int16* getData() { return (const int16*)chunk->abuf; }
+    // Size in bytes
+    inline int getSize() { return (int)chunk->alen; }
 };
 
 #endif // __SAMPLE_H__
@@ -26,6 +26,9 @@ protected:
 
 public:
 
+    // Destructor
+    virtual ~Scene() {}
+
     // Set references
     void setReferences(EventManager* evMan, 
         SceneManager* sceneMan, 
@@ -37,8 +40,33 @@ public:
     virtual void draw(Graphics* g) {}
     virtual void dispose() {}
     virtual void onChange(void* param) {}
+    // Called when a file has changed, if
+    // hot reloading is enabled
+    virtual void onFileChange(std::string path) {}
     virtual std::string getName() =0;
 
+    // Does the scene change without input. If
+    // not, it does not need to be redrawn
+    virtual bool isAnimating() { return true; }
+
+    // Copy what the scene draws to dst, a copy made
+    // earlier by this method or NULL, and return the
+    // copy. The copy can be drawn on another thread
+    // while the scene itself is updated
+    virtual Scene* copyState(Scene* dst) =0;
+
 };
 
+
+// Copy a whole scene, for the scenes that
+// have nothing shared to leave out
+template <class T> Scene* copyScene(T* s, Scene* dst) {
+
+    if(dst == NULL)
+        return new T(*s);
+
+    *(T*)dst = *s;
+    return dst;
+}
+
 #endif // __SCENE_H__
@@ -3,9 +3,74 @@
 
 #include "SceneManager.hpp"
 
+#include "Profiler.hpp"
+#include "Trace.hpp"
+
 #include <cstdio>
 
 
+// Draw the active & the global scene
+static void drawScenes(Graphics* g, Scene* activeScene, Scene* globalScene) {
+
+    ProfileScope scope("SceneManager::draw");
+
+    if(activeScene != NULL) {
+
+        std::string name = activeScene->getName();
+        TraceScope trace("Scene::draw", name.c_str());
+
+        Profiler::begin(name.c_str());
+        activeScene->draw(g);
+        Profiler::end();
+    }
+
+    if(globalScene != NULL) {
+
+        std::string name = globalScene->getName();
+        TraceScope trace("Scene::draw", name.c_str());
+
+        Profiler::begin(name.c_str());
+        globalScene->draw(g);
+        Profiler::end();
+    }
+}
+
+
+// Constructor
+SceneSnapshot::SceneSnapshot() {
+
+    activeScene = NULL;
+    globalScene = NULL;
+}
+
+
+// Destructor
+SceneSnapshot::~SceneSnapshot() {
+
+    clear();
+}
+
+
+// Draw the copies
+void SceneSnapshot::draw(Graphics* g) {
+
+    drawScenes(g, activeScene, globalScene);
+}
+
+
+// Remove the copies
+void SceneSnapshot::clear() {
+
+    for(int i = 0; i < copies.size(); ++ i) {
+
+        delete copies[i];
+    }
+    copies.clear();
+    activeScene = NULL;
+    globalScene = NULL;
+}
+
+
 // Constructor
 SceneManager::SceneManager(EventManager* evMan, AssetPack* assets) {
 
@@ -47,6 +112,8 @@ void SceneManager::addScene(Scene* s, bool makeActive, bool makeGlobal) {
 // Change active scene
 void SceneManager::changeActiveScene(std::string name, void* param) {
     
+    TraceScope trace("SceneManager::changeActiveScene", name.c_str());
+
     // Go through the scenes and try to find a
     // corresponding scene
     Scene* s = NULL;
@@ -79,22 +146,85 @@ void SceneManager::init() {
 // Update scenes
 void SceneManager::update(float tm) {
 
-    if(globalScene != NULL)
+    ProfileScope scope("SceneManager::update");
+
+    if(globalScene != NULL) {
+
+        std::string name = globalScene->getName();
+        TraceScope trace("Scene::update", name.c_str());
+
+        Profiler::begin(name.c_str());
         globalScene->update(tm);
+        Profiler::end();
+    }
+
+    if(activeScene != NULL) {
 
-    if(activeScene != NULL)
+        std::string name = activeScene->getName();
+        TraceScope trace("Scene::update", name.c_str());
+
+        Profiler::begin(name.c_str());
         activeScene->update(tm);
+        Profiler::end();
+    }
 }
 
 
 // Draw scenes
 void SceneManager::draw(Graphics* g){
 
-    if(activeScene != NULL)
-        activeScene->draw(g);
+    drawScenes(g, activeScene, globalScene);
+}
 
-    if(globalScene != NULL)
-        globalScene->draw(g);
+
+// Copy the active & the global scene
+void SceneManager::copyState(SceneSnapshot &s) {
+
+    ProfileScope scope("SceneManager::copyState");
+
+    // A copy is kept for every scene, so that
+    // switching scenes does not reallocate
+    s.copies.resize(scenes.size(), NULL);
+    s.activeScene = NULL;
+    s.globalScene = NULL;
+    for(int i = 0; i < scenes.size(); ++ i) {
+
+        if(scenes[i] != activeScene && scenes[i] != globalScene)
+            continue;
+
+        s.copies[i] = scenes[i]->copyState(s.copies[i]);
+        if(scenes[i] == activeScene)
+            s.activeScene = s.copies[i];
+        if(scenes[i] == globalScene)
+            s.globalScene = s.copies[i];
+    }
+}
+
+
+// Do the scenes change without input
+bool SceneManager::isAnimating() {
+
+    return (globalScene != NULL && globalScene->isAnimating()) ||
+        (activeScene != NULL && activeScene->isAnimating());
+}
+
+
+// Tell the scenes a file has changed
+void SceneManager::fileChanged(std::string path) {
+
+    TraceScope trace("SceneManager::fileChanged", path.c_str());
+
+    // The active scene is told last, so it sees
+    // what the others have reloaded
+    for(int i = 0; i < scenes.size(); ++ i) {
+
+        if(scenes[i] != activeScene)
+            scenes[i]->onFileChange(path);
+    }
+    if(activeScene != NULL) {
+
+        activeScene->onFileChange(path);
+    }
 }
 
 
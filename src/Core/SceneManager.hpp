@@ -11,6 +11,37 @@
 
 #include "Scene.hpp"
 
+// Copies of the scenes being drawn, made by
+// the scene manager. Lets another thread draw
+// while the scenes are updated
+class SceneSnapshot {
+
+    friend class SceneManager;
+
+private:
+
+    // Copies, in the order of the scenes
+    std::vector<Scene*> copies;
+    // Copies of the active & the global scene
+    Scene* activeScene;
+    Scene* globalScene;
+
+public:
+
+    // Constructor
+    SceneSnapshot();
+    // Destructor
+    ~SceneSnapshot();
+
+    // Draw the copies
+    void draw(Graphics* g);
+    // Remove the copies. Resources they have
+    // created for drawing are released on the
+    // calling thread
+    void clear();
+};
+
+
 // Scene manager
 class SceneManager {
 
@@ -45,6 +76,12 @@ public:
     void update(float tm);
     // Draw scenes
     void draw(Graphics* g);
+    // Copy the active & the global scene
+    void copyState(SceneSnapshot &s);
+    // Do the scenes change without input
+    bool isAnimating();
+    // Tell the scenes a file has changed
+    void fileChanged(std::string path);
 
     // Dispose scenes
     void dispose();
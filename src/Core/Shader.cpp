@@ -3,6 +3,9 @@
 
 #include "Shader.hpp"
 
+#include "GLState.hpp"
+#include "Trace.hpp"
+
 #include <GL/glew.h>
 #include <GL/gl.h>
 
@@ -17,43 +20,59 @@ static const std::string DEF_VERTEX =
 "#version 120\n"
 "attribute vec2 vertexPos;\n"
 "attribute vec2 vertexUV;\n"
-"uniform mat3 model;\n"
-"uniform mat3 view;\n"
-"uniform vec2 pos;\n"
-"uniform vec2 size;\n"
+"attribute vec4 vertexColor;\n"
+"uniform mat3 transf;\n"
+"uniform vec4 tint;\n"
 "varying vec2 uv;\n"
+"varying vec4 color;\n"
 "void main() {\n"
-"    vec2 p = vertexPos.xy;\n"
-"    p.x *= size.x;\n"
-"	 p.y *= size.y;\n"
-"	 p += pos;\n"
-"    gl_Position = vec4(view * model * vec3(p.x, p.y, 1), 1);\n"
-"    uv = vertexUV; \n"
+"    vec3 p = transf * vec3(vertexPos.x, vertexPos.y, 1);\n"
+"    gl_Position = vec4(p.x, p.y, 0, 1);\n"
+"    uv = vertexUV;\n"
+"    color = vertexColor * tint;\n"
 "}\n";
 static const std::string DEF_FRAG = 
 "#version 120\n"
 "varying vec2 uv;\n"  
+"varying vec4 color;\n"  
 "uniform sampler2D texSampler;\n"  
-"uniform vec2 texPos;\n"  
-"uniform vec2 texSize;\n"  
-"uniform vec4 color;\n"  
 "void main() {\n"  
 "    const float DELTA = 0.01;\n"  
-"    vec2 tex = uv;\n"  
-"    tex.x *= texSize.x;\n"  
-"    tex.y *= texSize.y;\n"  
-"    tex += texPos;\n"  
-"    vec4 res = color * texture2D(texSampler, tex);\n"  
+"    vec4 res = color * texture2D(texSampler, uv);\n"  
 "    if(res.a <= DELTA) {\n"  
 "        discard;\n"  
 "    }\n"  
 "    gl_FragColor = res;\n"  
 "}";
 
+// Instanced sprite shader. The corner of a unit
+// quad is moved to the instance rectangle, then
+// transformed by the affine transformation of
+// the instance, given as two rows
+static const std::string INSTANCE_VERTEX = 
+"#version 120\n"
+"attribute vec2 vertexPos;\n"
+"attribute vec3 instRow1;\n"
+"attribute vec3 instRow2;\n"
+"attribute vec4 instRect;\n"
+"attribute vec4 instUV;\n"
+"attribute vec4 instColor;\n"
+"uniform vec4 tint;\n"
+"varying vec2 uv;\n"
+"varying vec4 color;\n"
+"void main() {\n"
+"    vec3 q = vec3(instRect.xy + vertexPos * instRect.zw, 1);\n"
+"    gl_Position = vec4(dot(instRow1, q), dot(instRow2, q), 0, 1);\n"
+"    uv = mix(instUV.xy, instUV.zw, vertexPos);\n"
+"    color = instColor * tint;\n"
+"}\n";
+
 
 // Compile a shader
 static void compileShader(uint32 &shader, std::string src) {
 
+    TraceScope trace("compileShader");
+
     char errBuf[ERR_BUFFER_SIZE];
 
     int infoLen = 0;
@@ -84,15 +103,14 @@ static void linkProgram(uint32 &vertex, uint32 &frag, uint32 &prog) {
     int res = 0;
 
     // Link
-    prog = glCreateProgram();
 	glAttachShader(prog, vertex);
 	glAttachShader(prog, frag);
 	glLinkProgram(prog);
 
     // Check errors
-    glGetShaderiv(prog, GL_COMPILE_STATUS, &res);
-	glGetShaderiv(prog, GL_INFO_LOG_LENGTH, &infoLen);
-    if(infoLen > 0 ) {
+    glGetProgramiv(prog, GL_LINK_STATUS, &res);
+	glGetProgramiv(prog, GL_INFO_LOG_LENGTH, &infoLen);
+    if(res == GL_FALSE && infoLen > 0) {
 
 	    glGetProgramInfoLog(prog, infoLen, NULL, errBuf);
 		throw std::runtime_error(errBuf);
@@ -104,6 +122,8 @@ static void linkProgram(uint32 &vertex, uint32 &frag, uint32 &prog) {
 void Shader::build(std::string vertexSrc, 
         std::string fragmentSrc) {
 
+    TraceScope trace("Shader::build");
+
     // Create shaders
     GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
 	GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
@@ -112,9 +132,17 @@ void Shader::build(std::string vertexSrc,
     compileShader(vertex, vertexSrc);
     compileShader(fragment, fragmentSrc);
 
-    // Bind attribute locations
+    // Bind attribute locations (the program must
+    // exist before this)
+    program = glCreateProgram();
 	glBindAttribLocation(program, 0, "vertexPos");
 	glBindAttribLocation(program, 1, "vertexUV");
+	glBindAttribLocation(program, 2, "vertexColor");
+	glBindAttribLocation(program, 3, "instRow1");
+	glBindAttribLocation(program, 4, "instRow2");
+	glBindAttribLocation(program, 5, "instRect");
+	glBindAttribLocation(program, 6, "instUV");
+	glBindAttribLocation(program, 7, "instColor");
 
     // Link program
     linkProgram(vertex, fragment, program);
@@ -124,6 +152,17 @@ void Shader::build(std::string vertexSrc,
 	glDetachShader(program, fragment);
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
+
+    // Get uniforms
+    unifTex = glGetUniformLocation(program, "texSampler");
+    unifTransf = glGetUniformLocation(program, "transf");
+    unifTint = glGetUniformLocation(program, "tint");
+
+    // Set defaults
+    GLState::useProgram(program);
+    GLState::setUniform(unifTex, 0);
+    setMatrixUniforms(Affine2());
+    setColorUniforms(Color(1, 1, 1, 1));
 }
 
 
@@ -138,12 +177,25 @@ Shader::Shader() {
     // Build default
     build(DEF_VERTEX, DEF_FRAG);
 }
+Shader::Shader(int type) {
+
+    switch(type) {
+
+    case ShaderType::Instanced:
+        build(INSTANCE_VERTEX, DEF_FRAG);
+        break;
+
+    default:
+        build(DEF_VERTEX, DEF_FRAG);
+        break;
+    }
+}
 
 
 // Destructor
 Shader::~Shader() {
 
-    glDeleteProgram(program);
+    GLState::deleteProgram(program);
 }
 
 
@@ -151,42 +203,18 @@ Shader::~Shader() {
 void Shader::useShader() {
 
     // Use program
-    glUseProgram(program);
-
-    // Get uniforms
-    unifPos = glGetUniformLocation(program, "pos");
-	unifSize = glGetUniformLocation(program, "size");
-    unifModel = glGetUniformLocation(program, "model");
-    unifView = glGetUniformLocation(program, "view");
-    unifUVPos = glGetUniformLocation(program, "texPos");
-    unifUVSize = glGetUniformLocation(program, "texSize");
-    unifColor = glGetUniformLocation(program, "color");
-
-    // Set defaults
-    setMatrixUniforms(Matrix3().identity(), Matrix3().identity());
-    setVertexUniforms(Vector2(0, 0), Vector2(1, 1));
-    setUVUniforms(Vector2(0, 0), Vector2(1, 1));
-    setColorUniforms(Color(1, 1, 1, 1));
+    GLState::useProgram(program);
 }
 
 
 // Set uniforms
-void Shader::setMatrixUniforms(Matrix3 model, Matrix3 view) {
+void Shader::setMatrixUniforms(Affine2 transf) {
 
-    glUniformMatrix3fv(unifModel, 1, false, model.toArray());
-    glUniformMatrix3fv(unifView, 1, false, view.toArray());
-}
-void Shader::setVertexUniforms(Vector2 pos, Vector2 size) {
-    
-    glUniform2f(unifPos, pos.x, pos.y);
-    glUniform2f(unifSize, size.x, size.y);
-}
-void Shader::setUVUniforms(Vector2 pos, Vector2 size) {
-    
-    glUniform2f(unifUVPos, pos.x, pos.y);
-    glUniform2f(unifUVSize, size.x, size.y);
+    float arr[9];
+    transf.toArray(arr);
+    GLState::setUniformMatrix3(unifTransf, arr);
 }
 void Shader::setColorUniforms(Color col) {
     
-    glUniform4f(unifColor, col.r, col.g, col.b, col.a);
+    GLState::setUniform(unifTint, col.r, col.g, col.b, col.a);
 }
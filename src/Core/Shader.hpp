@@ -8,6 +8,17 @@
 
 #include <string>
 
+// Built-in shaders
+namespace ShaderType {
+
+    enum {
+
+        Default = 0,
+        Instanced = 1,
+    };
+}
+
+
 // Shader type
 class Shader {
 
@@ -17,13 +28,9 @@ private:
     uint32 program;
 
     // Uniforms
-    uint32 unifPos;
-    uint32 unifSize;
-    uint32 unifModel;
-    uint32 unifView;
-    uint32 unifUVPos;
-    uint32 unifUVSize;
-    uint32 unifColor;
+    int unifTex;
+    int unifTransf;
+    int unifTint;
 
     // Build shader
     void build(std::string vertex, 
@@ -35,15 +42,14 @@ public:
     Shader(std::string vertex, 
         std::string fragment);
     Shader();
+    Shader(int type);
     // Destructor
     ~Shader();
 
     // Use shader
     void useShader();
-    // Set uniforms
-    void setMatrixUniforms(Matrix3 model, Matrix3 view);
-    void setVertexUniforms(Vector2 pos, Vector2 size);
-    void setUVUniforms(Vector2 pos, Vector2 size);
+    // Set uniforms (the shader must be in use)
+    void setMatrixUniforms(Affine2 transf);
     void setColorUniforms(Color col);
 };
 
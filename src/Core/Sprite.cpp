@@ -85,4 +85,12 @@ void Sprite::draw(Graphics* g, Bitmap* bmp, float x, float y, int flip ){
 
     draw(g, bmp, frame, row, x, y, flip);
 }
-    
+
+
+// Draw as an instance
+void Sprite::drawInstance(Graphics* g, Bitmap* bmp, int frame, int row,
+        float dx, float dy, float x, float y, float angle, float scale) {
+
+    g->drawInstance(bmp, width * frame, height * row, width, height,
+        dx, dy, width, height, x, y, angle, scale);
+}
@@ -35,6 +35,12 @@ public:
     void draw(Graphics* g, Bitmap* bmp, int frame, int row, 
         float x, float y, int flip = 0);
     void draw(Graphics* g, Bitmap* bmp, float x, float y, int flip = 0);
+    // Draw as an instance. The frame is drawn at (dx, dy),
+    // scaled & rotated around the origin and then moved
+    // to (x, y)
+    void drawInstance(Graphics* g, Bitmap* bmp, int frame, int row,
+        float dx, float dy, float x, float y, 
+        float angle = 0.0f, float scale = 1.0f);
 
     // Getters
     inline int getWidth() { return width; }
@@ -0,0 +1,159 @@
+// Sprite batch
+// (c) 2019 Jani Nykänen
+
+#include "SpriteBatch.hpp"
+
+#include "GLState.hpp"
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+
+
+// Make room for a quad
+float* SpriteBatch::reserveQuad(Bitmap* bmp) {
+
+    // Texture changes or the batch is full,
+    // draw what we have so far
+    if(quadCount > 0 &&
+      (quadCount >= BATCH_MAX_QUADS ||
+       texture->getTexture() != bmp->getTexture()) ) {
+
+        flush();
+    }
+    texture = bmp;
+
+    return &vertices[(quadCount ++)*4*BATCH_VERTEX_SIZE];
+}
+
+
+// Set the texture coordinates and colors of a quad
+void SpriteBatch::setAttributes(float* out, 
+    float u1, float v1, float u2, float v2, Color col) {
+
+    const float UV[] = {u1,v1, u2,v1, u2,v2, u1,v2};
+
+    for(int i = 0; i < 4; ++ i) {
+
+        out[2] = UV[i*2]; out[3] = UV[i*2 +1];
+        out[4] = col.r; out[5] = col.g;
+        out[6] = col.b; out[7] = col.a;
+
+        out += BATCH_VERTEX_SIZE;
+    }
+}
+
+
+// Constructor
+SpriteBatch::SpriteBatch() {
+
+    // Allocate vertex storage
+    vertices = std::vector<float> (BATCH_MAX_QUADS*4*BATCH_VERTEX_SIZE);
+    quadCount = 0;
+    texture = NULL;
+
+    // Indices never change, so they can be
+    // computed right away
+    std::vector<uint16> indices (BATCH_MAX_QUADS*6);
+    uint16 v;
+    for(int i = 0; i < BATCH_MAX_QUADS; ++ i) {
+
+        v = (uint16)(i*4);
+        indices[i*6] = v;
+        indices[i*6 +1] = v+1;
+        indices[i*6 +2] = v+2;
+        indices[i*6 +3] = v+2;
+        indices[i*6 +4] = v+3;
+        indices[i*6 +5] = v;
+    }
+
+    // Generate buffers
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+
+    // Reserve space for vertices
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+        NULL, GL_STREAM_DRAW);
+
+    // Set indices
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16),
+        (const void*)&indices[0], GL_STATIC_DRAW);
+}
+
+
+// Destructor
+SpriteBatch::~SpriteBatch() {
+
+    GLState::deleteBuffer(vertexBuffer);
+    GLState::deleteBuffer(indexBuffer);
+}
+
+
+// Add a quad
+void SpriteBatch::pushQuad(Bitmap* bmp, Vector2* corners,
+    float u1, float v1, float u2, float v2, Color col) {
+
+    float* out = reserveQuad(bmp);
+    for(int i = 0; i < 4; ++ i) {
+
+        out[i*BATCH_VERTEX_SIZE] = corners[i].x;
+        out[i*BATCH_VERTEX_SIZE +1] = corners[i].y;
+    }
+    setAttributes(out, u1, v1, u2, v2, col);
+}
+
+
+// Add a transformed rectangle
+void SpriteBatch::pushQuad(Bitmap* bmp, Affine2 &m, 
+    float x, float y, float w, float h,
+    float u1, float v1, float u2, float v2, Color col) {
+
+    float* out = reserveQuad(bmp);
+    m.transformRect(x, y, w, h, out, BATCH_VERTEX_SIZE);
+    setAttributes(out, u1, v1, u2, v2, col);
+}
+
+
+// Bind buffers for use
+void SpriteBatch::bind() {
+
+    const int STRIDE = BATCH_VERTEX_SIZE * sizeof(float);
+
+    GLState::enableAttribs(BATCH_ATTRIBS);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    if(GLState::setVertexSource(vertexBuffer)) {
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, false, STRIDE, (void*)0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, false, STRIDE,
+            (void*)(2*sizeof(float)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, false, STRIDE,
+            (void*)(4*sizeof(float)));
+    }
+
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+}
+
+
+// Draw everything in the batch
+void SpriteBatch::flush() {
+
+    if(quadCount == 0) return;
+
+    texture->bind();
+    bind();
+
+    // Orphan the old storage so we do not have to
+    // wait for the previous draw call to finish
+    int size = quadCount*4*BATCH_VERTEX_SIZE * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+        NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, (const void*)&vertices[0]);
+
+    // Draw
+    glDrawElements(GL_TRIANGLES, quadCount*6,
+        GL_UNSIGNED_SHORT, (void*)0);
+
+    quadCount = 0;
+}
@@ -0,0 +1,68 @@
+// Sprite batch
+// (c) 2019 Jani Nykänen
+
+#ifndef __SPRITE_BATCH_H__
+#define __SPRITE_BATCH_H__
+
+#include "Types.hpp"
+#include "Bitmap.hpp"
+
+#include <vector>
+
+// Floats per vertex: position (2), UV (2), color (4)
+#define BATCH_VERTEX_SIZE 8
+// Vertex attributes used, as a bit mask
+#define BATCH_ATTRIBS 0x7
+// Maximum amount of quads in one draw call
+// (must fit 16-bit indices)
+#define BATCH_MAX_QUADS 4096
+
+
+// Sprite batch class
+class SpriteBatch {
+
+private:
+
+    // Buffers
+    uint32 vertexBuffer;
+    uint32 indexBuffer;
+
+    // Vertex data
+    std::vector<float> vertices;
+    // Quad count
+    int quadCount;
+
+    // Texture of the current batch
+    Bitmap* texture;
+
+    // Make room for a quad, returns where its
+    // vertices go
+    float* reserveQuad(Bitmap* bmp);
+    // Set the texture coordinates and colors of a quad
+    void setAttributes(float* out, 
+        float u1, float v1, float u2, float v2, Color col);
+
+public:
+
+    // Constructor
+    SpriteBatch();
+    // Destructor
+    ~SpriteBatch();
+
+    // Add a quad. Corners are given in the order
+    // top-left, top-right, bottom-right, bottom-left
+    void pushQuad(Bitmap* bmp, Vector2* corners,
+        float u1, float v1, float u2, float v2, Color col);
+    // Add a rectangle, transformed straight into
+    // the vertex data
+    void pushQuad(Bitmap* bmp, Affine2 &m, 
+        float x, float y, float w, float h,
+        float u1, float v1, float u2, float v2, Color col);
+
+    // Bind buffers for use
+    void bind();
+    // Draw everything in the batch
+    void flush();
+};
+
+#endif // __SPRITE_BATCH_H__
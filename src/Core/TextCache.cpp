@@ -0,0 +1,70 @@
+// Text mesh cache
+// (c) 2019 Jani Nykänen
+
+#include "TextCache.hpp"
+
+#include <functional>
+
+
+// Combine hashes
+static size_t combine(size_t seed, size_t h) {
+
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+
+// Hash function for text keys
+size_t TextKeyHash::operator()(const TextKey &k) const {
+
+    size_t h = std::hash<std::string>()(k.text);
+    h = combine(h, std::hash<void*>()((void*)k.font));
+    h = combine(h, (size_t)(k.xoff*31 + k.yoff));
+    return h;
+}
+
+
+// Constructor
+TextCache::TextCache(int capacity) {
+
+    this->capacity = capacity;
+}
+
+
+// Get a cached mesh
+Mesh* TextCache::get(const TextKey &key) {
+
+    std::unordered_map<TextKey, std::list<TextEntry>::iterator,
+        TextKeyHash>::iterator it = lookup.find(key);
+    if(it == lookup.end())
+        return NULL;
+
+    // Move to the front
+    entries.splice(entries.begin(), entries, it->second);
+    return &entries.front().mesh;
+}
+
+
+// Add a new mesh
+Mesh* TextCache::add(const TextKey &key) {
+
+    // Retire the least recently used entry
+    // if full
+    if((int)entries.size() >= capacity) {
+
+        lookup.erase(entries.back().key);
+        retired.splice(retired.end(), entries, --entries.end());
+    }
+
+    entries.push_front(TextEntry());
+    entries.front().key = key;
+    lookup[key] = entries.begin();
+
+    return &entries.front().mesh;
+}
+
+
+// Free the dropped entries
+void TextCache::endFrame() {
+
+    retired.clear();
+}
@@ -0,0 +1,81 @@
+// Text mesh cache
+// (c) 2019 Jani Nykänen
+
+#ifndef __TEXT_CACHE_H__
+#define __TEXT_CACHE_H__
+
+#include "Mesh.hpp"
+#include "Bitmap.hpp"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+
+// Everything that affects the layout of a string.
+// The glyphs are laid out at unit scale, the scale
+// and the shadow are applied when drawn
+struct TextKey {
+
+    std::string text;
+    Bitmap* font;
+    int xoff;
+    int yoff;
+
+    // Compare
+    inline bool operator==(const TextKey &k) const {
+
+        return font == k.font && xoff == k.xoff && 
+            yoff == k.yoff && text == k.text;
+    }
+};
+
+// Hash function for text keys
+struct TextKeyHash {
+
+    size_t operator()(const TextKey &k) const;
+};
+
+// A cached mesh
+struct TextEntry {
+
+    TextKey key;
+    Mesh mesh;
+};
+
+
+// Text cache class. Keeps the least recently
+// used meshes up to the given capacity
+class TextCache {
+
+private:
+
+    // Entries, the most recently used first
+    std::list<TextEntry> entries;
+    // Entries dropped this frame. Their meshes may
+    // still be queued, so they are kept until the
+    // frame has been drawn
+    std::list<TextEntry> retired;
+    // Lookup table
+    std::unordered_map<TextKey, std::list<TextEntry>::iterator,
+        TextKeyHash> lookup;
+    // Capacity
+    int capacity;
+
+public:
+
+    // Constructor
+    TextCache(int capacity = 128);
+
+    // Get a cached mesh, NULL if not found
+    Mesh* get(const TextKey &key);
+    // Add a new (empty) mesh for the key
+    Mesh* add(const TextKey &key);
+    // Free the dropped entries. Call after
+    // the frame has been drawn
+    void endFrame();
+
+    // Getters
+    inline int getSize() { return (int)entries.size(); }
+};
+
+#endif // __TEXT_CACHE_H__
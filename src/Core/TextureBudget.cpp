@@ -0,0 +1,91 @@
+// Texture memory budget
+// (c) 2019 Jani Nykänen
+
+#include "TextureBudget.hpp"
+
+#include "Bitmap.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+
+
+// Static members
+std::vector<Bitmap*> TextureBudget::textures;
+int64 TextureBudget::budget = 0;
+int64 TextureBudget::used = 0;
+int TextureBudget::frame = 0;
+int TextureBudget::evictions = 0;
+
+
+// Sorts textures by their last use, oldest first
+struct UseOrder {
+
+    inline bool operator()(Bitmap* a, Bitmap* b) const {
+
+        return a->getLastUse() < b->getLastUse();
+    }
+};
+
+
+// Set the budget
+void TextureBudget::setBudget(int64 bytes) {
+
+    budget = bytes;
+}
+
+
+// Add a texture
+void TextureBudget::add(Bitmap* bmp) {
+
+    textures.push_back(bmp);
+}
+
+
+// Remove a texture
+void TextureBudget::remove(Bitmap* bmp) {
+
+    auto it = std::find(textures.begin(), textures.end(), bmp);
+    if(it != textures.end())
+        textures.erase(it);
+}
+
+
+// Count the memory in use and evict textures
+void TextureBudget::endFrame() {
+
+    ++ frame;
+
+    used = 0;
+    for(int i = 0; i < textures.size(); ++ i) {
+
+        used += textures[i]->getByteSize();
+    }
+    Trace::counter("Texture memory (kB)", used / 1024.0);
+
+    if(budget <= 0 || used <= budget)
+        return;
+
+    // Textures that can be read again and
+    // have not been drawn for a while
+    std::vector<Bitmap*> unused;
+    for(int i = 0; i < textures.size(); ++ i) {
+
+        if(textures[i]->isResident() && textures[i]->canEvict() &&
+           frame - textures[i]->getLastUse() >= TEXTURE_EVICT_FRAMES) {
+
+            unused.push_back(textures[i]);
+        }
+    }
+    std::sort(unused.begin(), unused.end(), UseOrder());
+
+    int size;
+    for(int i = 0; i < unused.size() && used > budget; ++ i) {
+
+        size = unused[i]->getByteSize();
+        if(unused[i]->evict()) {
+
+            used -= size;
+            ++ evictions;
+        }
+    }
+}
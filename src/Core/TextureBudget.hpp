@@ -0,0 +1,58 @@
+// Texture memory budget
+// (c) 2019 Jani Nykänen
+
+#ifndef __TEXTURE_BUDGET_H__
+#define __TEXTURE_BUDGET_H__
+
+#include "Types.hpp"
+
+#include <vector>
+
+// Frames a texture must be unused before
+// it may be evicted
+#define TEXTURE_EVICT_FRAMES 60
+
+class Bitmap;
+
+
+// Keeps track of the GPU memory of the textures and
+// keeps it under a budget by evicting the ones not
+// drawn for a while, least recently drawn first.
+// Evicted textures are uploaded again from their
+// source when bound. Main thread only
+class TextureBudget {
+
+private:
+
+    // Textures, regions left out
+    static std::vector<Bitmap*> textures;
+    // Budget in bytes, 0 for no limit
+    static int64 budget;
+    // Bytes in use after the latest frame
+    static int64 used;
+    // Frames drawn
+    static int frame;
+    // Textures evicted so far
+    static int evictions;
+
+public:
+
+    // Set the budget, 0 for no limit
+    static void setBudget(int64 bytes);
+
+    // Add & remove a texture
+    static void add(Bitmap* bmp);
+    static void remove(Bitmap* bmp);
+
+    // Count the memory in use and evict textures
+    // if over the budget. Call after each frame
+    static void endFrame();
+
+    // Getters
+    inline static int getFrame() { return frame; }
+    inline static int64 getUsed() { return used; }
+    inline static int64 getBudget() { return budget; }
+    inline static int getEvictions() { return evictions; }
+};
+
+#endif // __TEXTURE_BUDGET_H__
@@ -0,0 +1,76 @@
+// Thread pool
+// (c) 2019 Jani Nykänen
+
+#include "ThreadPool.hpp"
+
+#include "Trace.hpp"
+
+
+// Worker thread
+void ThreadPool::work() {
+
+    Trace::setThreadName("Pool");
+
+    PoolJob job;
+    while(true) {
+
+        {
+            std::unique_lock<std::mutex> l(lock);
+            while(!quitting && jobs.empty()) {
+
+                wake.wait(l);
+            }
+            // Quit only when everything is done
+            if(jobs.empty())
+                return;
+
+            job = jobs.front();
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+
+// Constructor
+ThreadPool::ThreadPool(int count) {
+
+    if(count <= 0) {
+
+        count = std::thread::hardware_concurrency();
+        if(count <= 0) count = 1;
+    }
+
+    quitting = false;
+    for(int i = 0; i < count; ++ i) {
+
+        threads.push_back(std::thread(&ThreadPool::work, this));
+    }
+}
+
+
+// Destructor
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> l(lock);
+        quitting = true;
+    }
+    wake.notify_all();
+
+    for(int i = 0; i < threads.size(); ++ i) {
+
+        threads[i].join();
+    }
+}
+
+
+// Add a job
+void ThreadPool::submit(PoolJob job) {
+
+    {
+        std::lock_guard<std::mutex> l(lock);
+        jobs.push(job);
+    }
+    wake.notify_one();
+}
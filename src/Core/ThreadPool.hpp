@@ -0,0 +1,52 @@
+// Thread pool
+// (c) 2019 Jani Nykänen
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// A job to run on the pool
+typedef std::function<void (void)> PoolJob;
+
+
+// Thread pool. Runs jobs on worker threads in the
+// order they are submitted. Jobs left in the queue
+// are finished before the pool is destroyed
+class ThreadPool {
+
+private:
+
+    // Workers
+    std::vector<std::thread> threads;
+    // Jobs waiting for a worker
+    std::queue<PoolJob> jobs;
+    std::mutex lock;
+    std::condition_variable wake;
+    // Are the workers quitting
+    bool quitting;
+
+    // Worker thread
+    void work();
+
+public:
+
+    // Constructor. With no count given, there is
+    // a worker per hardware thread
+    ThreadPool(int count = 0);
+    // Destructor
+    ~ThreadPool();
+
+    // Add a job
+    void submit(PoolJob job);
+
+    // Getters
+    inline int getThreadCount() { return (int)threads.size(); }
+};
+
+#endif // __THREAD_POOL_H__
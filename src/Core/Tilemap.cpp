@@ -1,149 +1,407 @@
-// A simple single-layer tilemap
-// (NOTE: very ugly & simple, zero error
-//  checking!)
+// A simple tilemap
 // (c) 2019 Jani Nykänen
 
 #include "Tilemap.hpp"
 
-#include <fstream>
+#include "Trace.hpp"
+#include "Utility.hpp"
+
 #include <stdexcept>
 #include <cstdio>
-#include <sstream>
+#include <cstring>
 
+#include <sys/stat.h>
 
-// Find parameter value
-static std::string findValue(std::string content, 
-    std::string what) {
 
-    std::string lookFor = what + "=\"";
-    int p = content.find(lookFor) + lookFor.length();
-    // Find the next quotation mark
-    int i = p;
-    for(; i < content.length(); ++ i) {
+// A piece of the file, not copied
+struct TextSpan {
 
-        if(content[i] == '"') {
-            break;
-        }
+    const char* begin;
+    const char* end;
+
+    // Constructor
+    inline TextSpan(const char* begin = NULL, const char* end = NULL) {
+
+        this->begin = begin;
+        this->end = end;
+    }
+
+    // Compare to a string
+    inline bool equals(const char* str) const {
+
+        int len = (int)strlen(str);
+        return end - begin == len && strncmp(begin, str, len) == 0;
     }
+    // Copy to a string
+    inline std::string toString() const {
 
-    return content.substr(p,i-p);
+        return std::string(begin, end - begin);
+    }
+};
+
+
+// Is a whitespace
+static inline bool isSpace(char c) {
+
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
 }
 
 
-// Parse properties
-static void parseProperties(std::string content,
-    std::vector<KeyValuePair> &properties) {
+// Read a signed integer, skipping anything before it.
+// Returns false if there is none before the end
+static bool scanInt(const char* &p, const char* end, int &out) {
+
+    while(p < end && !(*p >= '0' && *p <= '9') && *p != '-')
+        ++ p;
+    if(p == end) return false;
+
+    bool neg = *p == '-';
+    if(neg) ++ p;
 
-    // Find all the property positions
-    std::vector<int> propPos;
-    std::vector<int> propEnds;
+    // Unsigned, since Tiled stores the flip
+    // flags in the highest bits
+    uint32 v = 0;
+    for(; p < end && *p >= '0' && *p <= '9'; ++ p) {
+
+        v = v * 10 + (*p - '0');
+    }
+    out = neg ? -(int)v : (int)v;
+
+    return true;
+}
 
-    int p = 0;
-    int oldP = 0;
-    // Find property positions
-    std::string find = "<property";
-    while(true) {
 
-        oldP = p;
-        p = content.find(find, p+find.length());
-        if(p <= oldP)
-            break;
+// Read the next attribute of a tag. Returns false
+// when the tag ends, p is then after the '>'
+static bool nextAttribute(const char* &p, const char* end,
+    TextSpan &name, TextSpan &value) {
 
-        // Push
-        propPos.push_back(p + find.length());
+    while(p < end && isSpace(*p)) ++ p;
+    if(p >= end) return false;
+    if(*p == '>' || *p == '/' || *p == '?') {
+
+        while(p < end && *p != '>') ++ p;
+        if(p < end) ++ p;
+        return false;
     }
 
-    // Find property keys & values
-    // TODO: Inefficient with big data!
-    std::string key, value;
-    for(int i = 0; i < propPos.size(); ++ i) {
+    // Name
+    name.begin = p;
+    while(p < end && *p != '=' && *p != '>' && !isSpace(*p)) ++ p;
+    name.end = p;
 
-        key = findValue(content.substr(propPos[i]), "name");
-        value = findValue(content.substr(propPos[i]), "value");
+    // Value, in either quotes
+    while(p < end && *p != '"' && *p != '\'' && *p != '>') ++ p;
+    if(p >= end || *p == '>') {
 
-        // Store properties
-        properties.push_back(KeyValuePair(key, value));
+        value = TextSpan(p, p);
+        return true;
     }
+    char quote = *(p ++);
+    value.begin = p;
+    while(p < end && *p != quote) ++ p;
+    value.end = p;
+    if(p < end) ++ p;
+
+    return true;
 }
 
 
-// Parse CSV (to integers)
-static void parseCSVInt(std::string content, 
-    std::vector<int> &data) {
+// Parse the content of a TMX file
+void Tilemap::parse(const char* p, const char* end) {
+
+    width = 0;
+    height = 0;
+    difficulty = 0;
+    moves = 0;
+
+    TextSpan tag, name, value;
+    TextSpan propName, propValue;
+    bool csv;
+    Layer* layer = NULL;
+    int count;
+    while(p < end) {
+
+        // Find the next tag
+        p = (const char*)memchr(p, '<', end - p);
+        if(p == NULL) break;
+        ++ p;
+
+        // Skip closing tags, comments & declarations
+        if(p < end && (*p == '/' || *p == '!' || *p == '?')) {
+
+            continue;
+        }
+
+        tag.begin = p;
+        while(p < end && !isSpace(*p) && *p != '>' && *p != '/') ++ p;
+        tag.end = p;
 
-    std::string buffer = "";
-    int count = 0;
-    char c;
-    for(int i = 0; i < content.size(); ++ i) {
+        // Map
+        if(tag.equals("map")) {
 
-        c = content[i];
-        if(buffer.length() > 0 && c == ',') {
+            while(nextAttribute(p, end, name, value)) {
 
-            if(count < data.size()) {
-                
-                std::istringstream(buffer) >> data[count ++];
-                buffer = "";
+                if(name.equals("width"))
+                    scanInt(value.begin, value.end, width);
+                else if(name.equals("height"))
+                    scanInt(value.begin, value.end, height);
             }
         }
-        // Push to the buffer if not a whitespace
-        else if(!(c == ' ' || c == '\n' || c == '\t')) {
+        // Property
+        else if(tag.equals("property")) {
 
-            buffer.push_back(content[i]);
+            propName = TextSpan();
+            propValue = TextSpan();
+            while(nextAttribute(p, end, name, value)) {
+
+                if(name.equals("name"))
+                    propName = value;
+                else if(name.equals("value"))
+                    propValue = value;
+            }
+            properties.push_back(KeyValuePair(propName.toString(),
+                propValue.toString()));
+
+            // Stage properties
+            if(propName.equals("name"))
+                stageName = properties.back().value;
+            else if(propName.equals("difficulty"))
+                scanInt(propValue.begin, propValue.end, difficulty);
+            else if(propName.equals("moves"))
+                scanInt(propValue.begin, propValue.end, moves);
+        }
+        // Layer, its data follows
+        else if(tag.equals("layer")) {
+
+            while(nextAttribute(p, end, name, value));
+
+            layers.push_back(Layer(width*height, 0));
+            layer = &layers.back();
+        }
+        // Layer data
+        else if(tag.equals("data")) {
+
+            csv = false;
+            while(nextAttribute(p, end, name, value)) {
+
+                if(name.equals("encoding"))
+                    csv = value.equals("csv");
+            }
+            if(layer == NULL) continue;
+            if(!csv) {
+
+                throw std::runtime_error("Only CSV encoded layers "
+                    "are supported");
+            }
+
+            // Read the tiles in place, up to the end tag
+            const char* dataEnd = (const char*)memchr(p, '<', end - p);
+            if(dataEnd == NULL) dataEnd = end;
+
+            count = 0;
+            while(count < (int)layer->size() &&
+                  scanInt(p, dataEnd, (*layer)[count])) {
+
+                ++ count;
+            }
+            p = dataEnd;
+            layer = NULL;
         }
     }
-    if(buffer.length() > 0) {
 
-         std::istringstream(buffer) >> data[count ++];
+    // Always at least one layer
+    if(layers.empty()) {
+
+        layers.push_back(Layer(width*height, 0));
     }
 }
 
 
+// Read a 32-bit value of the compiled form
+static int32 readInt(const uint8* &p, const uint8* end) {
+
+    if(end - p < 4)
+        throw std::runtime_error("Broken compiled stage");
+
+    int32 v;
+    memcpy(&v, p, 4);
+    p += 4;
+    return v;
+}
+
+
+// Read a string of the compiled form
+static std::string readString(const uint8* &p, const uint8* end) {
+
+    int32 len = readInt(p, end);
+    if(len < 0 || end - p < len)
+        throw std::runtime_error("Broken compiled stage");
+
+    std::string str((const char*)p, len);
+    p += len;
+    return str;
+}
+
 
-// Constructor
+// Write a 32-bit value of the compiled form
+static void writeInt(std::vector<uint8> &out, int32 v) {
+
+    out.insert(out.end(), (uint8*)&v, (uint8*)&v + 4);
+}
+
+
+// Write a string of the compiled form
+static void writeString(std::vector<uint8> &out, const std::string &str) {
+
+    writeInt(out, (int32)str.length());
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+
+// Read the compiled form
+void Tilemap::parse(const uint8* bin, const uint8* end) {
+
+    if(end - bin < (int)sizeof(TilemapHeader))
+        throw std::runtime_error("Broken compiled stage");
+
+    TilemapHeader h;
+    memcpy(&h, bin, sizeof(TilemapHeader));
+    bin += sizeof(TilemapHeader);
+    if(memcmp(h.magic, TILEMAP_MAGIC, 4) != 0 ||
+       h.version != TILEMAP_VERSION ||
+       h.width < 0 || h.height < 0 || h.layerCount < 0 ||
+       h.name[TILEMAP_NAME_LENGTH-1] != 0) {
+
+        throw std::runtime_error("Broken compiled stage");
+    }
+
+    width = h.width;
+    height = h.height;
+    difficulty = h.difficulty;
+    moves = h.moves;
+    stageName = std::string(h.name);
+
+    // Tiles
+    int size = width*height;
+    if(size > 0 && (end - bin) / 4 / size < h.layerCount)
+        throw std::runtime_error("Broken compiled stage");
+
+    layers = std::vector<Layer> (h.layerCount, Layer(size));
+    for(int i = 0; i < h.layerCount && size > 0; ++ i) {
+
+        memcpy(&layers[i][0], bin, size*4);
+        bin += size*4;
+    }
+    if(layers.empty()) {
+
+        layers.push_back(Layer(size, 0));
+    }
+
+    // Properties
+    std::string key;
+    for(int i = 0; i < h.propertyCount; ++ i) {
+
+        key = readString(bin, end);
+        properties.push_back(KeyValuePair(key, readString(bin, end)));
+    }
+}
+
+
+// Constructors
 Tilemap::Tilemap(std::string path) {
 
-    // Read file to a string
-    std::string content = "";
-    std::ifstream file(path.c_str());
-    if(file.is_open() == false) {
+    TraceScope trace("Tilemap::Tilemap", path.c_str());
+
+    this->path = path;
+
+    // Read the file once, it is parsed in place
+    std::vector<uint8> content;
+    if(!readFile(path, content)) {
 
         throw std::runtime_error("Failed to open a file in " + path);
     }
 
-    // Read lines
-    std::string line;
-    while (std::getline(file, line)) {
+    const uint8* data = content.empty() ? NULL : &content[0];
+    if(content.size() >= 4 && memcmp(data, TILEMAP_MAGIC, 4) == 0) {
 
-        content += line;
+        parse(data, data + content.size());
     }
+    else {
 
-    // Find dimensions
-    std::istringstream(findValue(content,"width")) >> width;
-    std::istringstream(findValue(content,"height")) >> height;
+        parse((const char*)data, (const char*)data + content.size());
+    }
+}
+Tilemap::Tilemap(const char* text, int length) {
 
-    // Parse properties
-    properties = std::vector<KeyValuePair> ();
-    parseProperties(content, properties);
+    parse(text, text + length);
+}
+Tilemap::Tilemap(const uint8* bin, int size) {
+
+    parse(bin, bin + size);
+}
 
-    // Parse map data
-    std::string findBegin = "<data encoding=\"csv\">";
-    std::string findEnd = "</data>";
-    int begin = content.find(findBegin) + findBegin.length();
-    int end = content.find(findEnd);
-    // Allocate memory
-    data = std::vector<int> (width*height);
-    // Parse CSV
-    parseCSVInt(content.substr(begin, end-begin), data);
+
+// Load a compiled stage or a TMX file
+Tilemap Tilemap::load(std::string base) {
+
+    std::string stage = base + ".stage";
+    std::string tmx = base + ".tmx";
+
+    struct stat stageStat, tmxStat;
+    bool hasStage = stat(stage.c_str(), &stageStat) == 0;
+    bool hasTmx = stat(tmx.c_str(), &tmxStat) == 0;
+
+    if(hasStage && (!hasTmx || stageStat.st_mtime >= tmxStat.st_mtime)) {
+
+        return Tilemap(stage);
+    }
+    return Tilemap(tmx);
+}
+
+
+// Get the compiled form
+void Tilemap::serialize(std::vector<uint8> &out) {
+
+    TilemapHeader h;
+    memset(&h, 0, sizeof(TilemapHeader));
+    memcpy(h.magic, TILEMAP_MAGIC, 4);
+    h.version = TILEMAP_VERSION;
+    h.width = width;
+    h.height = height;
+    h.layerCount = (int32)layers.size();
+    h.propertyCount = (int32)properties.size();
+    h.difficulty = difficulty;
+    h.moves = moves;
+    strncpy(h.name, stageName.c_str(), TILEMAP_NAME_LENGTH-1);
+
+    out.insert(out.end(), (uint8*)&h, (uint8*)&h + sizeof(TilemapHeader));
+    for(int l = 0; l < layers.size(); ++ l) {
+
+        if(!layers[l].empty()) {
+
+            out.insert(out.end(), (uint8*)&layers[l][0], 
+                (uint8*)&layers[l][0] + layers[l].size()*4);
+        }
+    }
+    // All the properties are kept, so getProp
+    // works the same for both forms
+    for(int i = 0; i < properties.size(); ++ i) {
+
+        writeString(out, properties[i].key);
+        writeString(out, properties[i].value);
+    }
 }
 
 
-// Get tile
-int Tilemap::getTile(int x, int y) {
+// Get a tile of a layer
+int Tilemap::getTile(int layer, int x, int y) {
 
-    if(x < 0 || y < 0 || x >= width || y >= height)
+    if(layer < 0 || layer >= layers.size() ||
+       x < 0 || y < 0 || x >= width || y >= height)
         return -1;
 
-    return data[y*width +x];
+    return layers[layer][y*width +x];
 }
 
 
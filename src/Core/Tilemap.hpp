@@ -1,6 +1,4 @@
-// A simple single-layer tilemap
-// (NOTE: very ugly & simple, zero error
-//  checking!)
+// A simple tilemap
 // (c) 2019 Jani Nykänen
 
 #ifndef __TILEMAP_H__
@@ -13,38 +11,98 @@
 
 typedef std::vector<int> Layer;
 
+// Compiled stage file identifier & version
+#define TILEMAP_MAGIC "P19M"
+#define TILEMAP_VERSION 1
+// Longest stage name kept in the header,
+// with the terminator
+#define TILEMAP_NAME_LENGTH 32
+
+// Header of the compiled form. The layers follow
+// it as raw 32-bit tiles, then all the properties
+// as length-prefixed keys & values
+struct TilemapHeader {
+
+    char magic[4];
+    uint32 version;
+    int32 width;
+    int32 height;
+    int32 layerCount;
+    int32 propertyCount;
+    // Stage properties, parsed
+    int32 difficulty;
+    int32 moves;
+    char name[TILEMAP_NAME_LENGTH];
+};
+
 // Tilemap type
 class Tilemap {
 
 private:
 
-    // Data
-    std::vector<int> data;
+    // File loaded from, empty if none
+    std::string path;
+
+    // Layers, all of the size of the map
+    std::vector<Layer> layers;
     // Dimensions
     int width;
     int height;
 
     // Properties
     std::vector<KeyValuePair> properties;
+    // Stage properties, parsed
+    std::string stageName;
+    int difficulty;
+    int moves;
+
+    // Parse the content of a TMX file
+    void parse(const char* text, const char* end);
+    // Read the compiled form
+    void parse(const uint8* bin, const uint8* end);
 
 public:
 
-    // Constructor
+    // Constructors
     inline Tilemap() {}
+    // From a TMX file with CSV encoded layers, or
+    // from a compiled stage file
     Tilemap(std::string path);
+    // From the content of a TMX file
+    Tilemap(const char* text, int length);
+    // From the compiled form, throws if
+    // the data is broken
+    Tilemap(const uint8* bin, int size);
+
+    // Load "base.stage", or "base.tmx" if there is
+    // no compiled stage or the TMX file is newer
+    static Tilemap load(std::string base);
+
+    // Get the compiled form
+    void serialize(std::vector<uint8> &out);
 
     // Get dimensions
     inline int getWidth(){return width;}
     inline int getHeight(){return height;}
-    // Copy data
+    inline int getLayerCount(){return (int)layers.size();}
+    // Copy data of the first layer
     inline std::vector<int> copyData() {
-        return data;
+        return layers[0];
     }
 
-    // Get a tile
-    int getTile(int x, int y);
+    // Get a tile of the first layer
+    inline int getTile(int x, int y) { return getTile(0, x, y); }
+    // Get a tile of a layer
+    int getTile(int layer, int x, int y);
     // Get a property
     std::string getProp(std::string name);
+
+    // Get stage properties
+    inline std::string getName() { return stageName; }
+    inline int getDifficulty() { return difficulty; }
+    inline int getMoveTarget() { return moves; }
+    // Get the file loaded from
+    inline std::string getPath() { return path; }
 };
 
 #endif // __TILEMAP_H__
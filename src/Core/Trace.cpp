@@ -0,0 +1,353 @@
+// Trace recorder
+// (c) 2019 Jani Nykänen
+
+#include "Trace.hpp"
+
+#include "Utility.hpp"
+
+#include <cstring>
+#include <chrono>
+
+// Time between writes, in milliseconds
+static const int WRITE_INTERVAL = 100;
+// How often the writer checks if it should stop
+static const int WRITE_POLL = 10;
+
+// Buffer of the calling thread
+static thread_local TraceBuffer* threadBuffer = NULL;
+// Name of the calling thread
+static thread_local const char* threadName = NULL;
+
+// Static members
+std::atomic<bool> Trace::enabled (false);
+std::string Trace::path = "trace.json";
+FILE* Trace::file = NULL;
+bool Trace::firstEvent;
+int64 Trace::startTime;
+std::vector<TraceBuffer*> Trace::buffers;
+std::mutex Trace::bufferLock;
+std::thread Trace::writer;
+std::atomic<bool> Trace::writing (false);
+
+
+// Constructor
+TraceBuffer::TraceBuffer(int id, std::string name) {
+
+    this->id = id;
+    this->name = name;
+    named = false;
+
+    head = 0;
+    tail = 0;
+    dropped = 0;
+}
+
+
+// Add an event
+bool TraceBuffer::push(const TraceEvent &e) {
+
+    uint32 h = head.load(std::memory_order_relaxed);
+    if(h - tail.load(std::memory_order_acquire) >= TRACE_BUFFER_SIZE) {
+
+        ++ dropped;
+        return false;
+    }
+
+    events[h % TRACE_BUFFER_SIZE] = e;
+    head.store(h+1, std::memory_order_release);
+
+    return true;
+}
+
+
+// Take the oldest event
+bool TraceBuffer::pop(TraceEvent &e) {
+
+    uint32 t = tail.load(std::memory_order_relaxed);
+    if(t == head.load(std::memory_order_acquire))
+        return false;
+
+    e = events[t % TRACE_BUFFER_SIZE];
+    tail.store(t+1, std::memory_order_release);
+
+    return true;
+}
+
+
+// Get the buffer of the calling thread
+TraceBuffer* Trace::getBuffer() {
+
+    if(threadBuffer != NULL)
+        return threadBuffer;
+
+    std::lock_guard<std::mutex> lock(bufferLock);
+
+    int id = buffers.size() + 1;
+    threadBuffer = new TraceBuffer(id, threadName != NULL ?
+        std::string(threadName) : "Thread " + intToString(id));
+    buffers.push_back(threadBuffer);
+
+    return threadBuffer;
+}
+
+
+// Add an event of the calling thread
+void Trace::push(TraceEvent &e, const char* name, const char* detail) {
+
+    strncpy(e.name, name, TRACE_NAME_LENGTH-1);
+    e.name[TRACE_NAME_LENGTH-1] = 0;
+
+    e.detail[0] = 0;
+    if(detail != NULL) {
+
+        strncpy(e.detail, detail, TRACE_NAME_LENGTH-1);
+        e.detail[TRACE_NAME_LENGTH-1] = 0;
+    }
+
+    getBuffer()->push(e);
+}
+
+
+// Write a string to the file, escaped
+void Trace::writeString(const char* str) {
+
+    fputc('"', file);
+    for(; *str != 0; ++ str) {
+
+        if(*str == '"' || *str == '\\')
+            fputc('\\', file);
+
+        // Control characters are not
+        // worth escaping properly
+        fputc((unsigned char)*str < 32 ? ' ' : *str, file);
+    }
+    fputc('"', file);
+}
+
+
+// Write the buffered events to the file
+void Trace::drain() {
+
+    std::lock_guard<std::mutex> lock(bufferLock);
+
+    TraceEvent e;
+    TraceBuffer* b;
+    for(int i = 0; i < buffers.size(); ++ i) {
+
+        b = buffers[i];
+        if(file == NULL) {
+
+            while(b->pop(e));
+            continue;
+        }
+
+        // Name the thread
+        if(!b->named) {
+
+            fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"name\":\"thread_name\",\"args\":{\"name\":",
+                firstEvent ? "" : ",\n", b->id);
+            writeString(b->name.c_str());
+            fprintf(file, "}}");
+
+            firstEvent = false;
+            b->named = true;
+        }
+
+        while(b->pop(e)) {
+
+            fprintf(file, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,"
+                "\"ts\":%.3f,\"name\":",
+                e.phase, b->id, (e.time - startTime) / 1000.0);
+            writeString(e.name);
+
+            if(e.phase == 'X') {
+
+                fprintf(file, ",\"dur\":%.3f", e.duration / 1000.0);
+                if(e.detail[0] != 0) {
+
+                    fprintf(file, ",\"args\":{\"detail\":");
+                    writeString(e.detail);
+                    fprintf(file, "}");
+                }
+            }
+            else {
+
+                fprintf(file, ",\"args\":{\"value\":%g}", e.value);
+            }
+            fprintf(file, "}");
+        }
+    }
+}
+
+
+// Writer thread
+void Trace::writeLoop() {
+
+    int waited = 0;
+    while(writing) {
+
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(WRITE_POLL));
+
+        waited += WRITE_POLL;
+        if(waited >= WRITE_INTERVAL) {
+
+            drain();
+            waited = 0;
+        }
+    }
+}
+
+
+// Set the output file
+void Trace::setPath(std::string path) {
+
+    Trace::path = path;
+}
+
+
+// Start recording
+bool Trace::start() {
+
+    if(enabled) return true;
+
+    // Forget whatever was left from before
+    drain();
+
+    file = fopen(path.c_str(), "w");
+    if(file == NULL) {
+
+        printf("Warning: could not open trace file %s\n", path.c_str());
+        return false;
+    }
+    fprintf(file, "[\n");
+    firstEvent = true;
+
+    // Threads named before are named again
+    for(int i = 0; i < buffers.size(); ++ i) {
+
+        buffers[i]->named = false;
+    }
+
+    startTime = getNanoTime();
+    writing = true;
+    writer = std::thread(writeLoop);
+    enabled = true;
+
+    printf("Recording a trace to %s\n", path.c_str());
+
+    return true;
+}
+
+
+// Stop recording
+void Trace::stop() {
+
+    if(!enabled) return;
+    enabled = false;
+
+    writing = false;
+    writer.join();
+
+    // Write the rest
+    drain();
+    fprintf(file, "\n]\n");
+    fclose(file);
+    file = NULL;
+
+    // Tell if something was lost
+    uint32 dropped = 0;
+    for(int i = 0; i < buffers.size(); ++ i) {
+
+        dropped += buffers[i]->dropped.exchange(0);
+    }
+    printf("Trace written to %s", path.c_str());
+    if(dropped > 0) {
+
+        printf(" (%u events dropped)", dropped);
+    }
+    printf("\n");
+}
+
+
+// Start or stop recording
+void Trace::toggle() {
+
+    if(enabled)
+        stop();
+    else
+        start();
+}
+
+
+// Free the buffers
+void Trace::dispose() {
+
+    stop();
+
+    std::lock_guard<std::mutex> lock(bufferLock);
+    for(int i = 0; i < buffers.size(); ++ i) {
+
+        delete buffers[i];
+    }
+    buffers.clear();
+    threadBuffer = NULL;
+}
+
+
+// Name the calling thread
+void Trace::setThreadName(const char* name) {
+
+    threadName = name;
+}
+
+
+// Add a timed scope
+void Trace::complete(const char* name, const char* detail,
+    int64 start, int64 end) {
+
+    if(!isEnabled()) return;
+
+    // Started before the recording did
+    if(start < startTime)
+        start = startTime;
+
+    TraceEvent e;
+    e.phase = 'X';
+    e.time = start;
+    e.duration = end - start;
+    push(e, name, detail);
+}
+
+
+// Add a counter value
+void Trace::counter(const char* name, double value) {
+
+    if(!isEnabled()) return;
+
+    TraceEvent e;
+    e.phase = 'C';
+    e.time = getNanoTime();
+    e.value = value;
+    push(e, name, NULL);
+}
+
+
+// Constructor
+TraceScope::TraceScope(const char* name, const char* detail) {
+
+    this->name = name;
+    this->detail = detail;
+    start = Trace::isEnabled() ? getNanoTime() : 0;
+}
+
+
+// Destructor
+TraceScope::~TraceScope() {
+
+    if(start != 0) {
+
+        Trace::complete(name, detail, start, getNanoTime());
+    }
+}
@@ -0,0 +1,162 @@
+// Trace recorder
+// (c) 2019 Jani Nykänen
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "Types.hpp"
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+
+// Events buffered per thread
+#define TRACE_BUFFER_SIZE 8192
+// Longest name stored, longer ones are cut
+#define TRACE_NAME_LENGTH 48
+
+
+// A trace event
+struct TraceEvent {
+
+    // 'X' for a timed scope, 'C' for a counter
+    char phase;
+    // Name and an optional detail, like the
+    // name of the asset being loaded
+    char name[TRACE_NAME_LENGTH];
+    char detail[TRACE_NAME_LENGTH];
+    // Start time and duration in nanoseconds
+    int64 time;
+    int64 duration;
+    // Counter value
+    double value;
+};
+
+
+// Events of a thread. Only the thread writes to
+// it and only the writer thread reads it, so
+// neither needs a lock
+class TraceBuffer {
+
+private:
+
+    // Ring buffer
+    TraceEvent events[TRACE_BUFFER_SIZE];
+    // Next event to write and to read
+    std::atomic<uint32> head;
+    std::atomic<uint32> tail;
+
+public:
+
+    // Thread id & name in the trace
+    int id;
+    std::string name;
+    // Has the name been written
+    bool named;
+    // Events lost because the buffer was full
+    std::atomic<uint32> dropped;
+
+    // Constructor
+    TraceBuffer(int id, std::string name);
+
+    // Add an event, owner thread only. Returns
+    // false if the buffer is full
+    bool push(const TraceEvent &e);
+    // Take the oldest event, writer thread only.
+    // Returns false if there is none
+    bool pop(TraceEvent &e);
+};
+
+
+// Trace recorder. Writes timed scopes and counters
+// of every thread to a file in the Chrome trace
+// format (chrome://tracing, Perfetto). Events are
+// written by a background thread while recording
+class Trace {
+
+private:
+
+    // Is recording
+    static std::atomic<bool> enabled;
+    // Output file
+    static std::string path;
+    static FILE* file;
+    // Is the next event the first one in the file
+    static bool firstEvent;
+    // Time the recording started
+    static int64 startTime;
+
+    // Buffers of every thread that has recorded
+    // something. The lock is only needed when
+    // a thread records its first event
+    static std::vector<TraceBuffer*> buffers;
+    static std::mutex bufferLock;
+
+    // Writer thread
+    static std::thread writer;
+    static std::atomic<bool> writing;
+
+    // Get the buffer of the calling thread
+    static TraceBuffer* getBuffer();
+    // Add an event of the calling thread
+    static void push(TraceEvent &e, const char* name, const char* detail);
+    // Write the buffered events to the file. If
+    // the file is NULL, they are thrown away
+    static void drain();
+    // Writer thread
+    static void writeLoop();
+    // Write a string to the file, escaped
+    static void writeString(const char* str);
+
+public:
+
+    // Set the output file
+    static void setPath(std::string path);
+    // Start recording. Returns false if the
+    // file could not be opened
+    static bool start();
+    // Stop recording and finish the file
+    static void stop();
+    // Start or stop recording
+    static void toggle();
+    // Free the buffers. Other threads must not
+    // record anything after this
+    static void dispose();
+
+    // Name the calling thread in the trace
+    static void setThreadName(const char* name);
+
+    // Add a timed scope, times from getNanoTime
+    static void complete(const char* name, const char* detail,
+        int64 start, int64 end);
+    // Add a counter value
+    static void counter(const char* name, double value);
+
+    // Is recording
+    inline static bool isEnabled() {
+
+        return enabled.load(std::memory_order_acquire);
+    }
+};
+
+
+// Traces the scope it is created in. The
+// strings must live as long as the scope
+class TraceScope {
+
+private:
+
+    const char* name;
+    const char* detail;
+    int64 start;
+
+public:
+
+    TraceScope(const char* name, const char* detail = NULL);
+    ~TraceScope();
+};
+
+#endif // __TRACE_H__
@@ -3,20 +3,22 @@
 
 #include "Transformations.hpp"
 
+#include <stdexcept>
 
-// Pass transformations to shader
-void Transformations::passToShader(Shader* s) {
 
-    s->setMatrixUniforms(model, view);
+// Get the combined view & model transformation
+Affine2 Transformations::getCombined() {
+
+    return view.mul(model);
 }
 
 
 // Constructor
 Transformations::Transformations() {
 
-    model = Matrix3();
-    view = Matrix3();
-    operand = Matrix3();
+    model = Affine2();
+    view = Affine2();
+    stackSize = 0;
 
     viewport = Vector2(1, 1);
     fbSize = Vector2(1, 1);
@@ -30,18 +32,15 @@ void Transformations::identity() {
 }
 void Transformations::translate(float x, float y) {
     
-    operand.translate(x, y);
-    model = model.mul(operand);
+    model.translate(x, y);
 }
 void Transformations::scale(float x, float y) {
 
-    operand.scale(x, y);
-    model = model.mul(operand);
+    model.scale(x, y);
 }
 void Transformations::rotate(float angle) {
     
-    operand.rotate(angle);
-    model = model.mul(operand);
+    model.rotate(angle);
 }
 
 
@@ -64,10 +63,17 @@ void Transformations::setView(float h) {
 // Stack operations
 void Transformations::push() {
 
-    stack.push(model);
+    if(stackSize >= TRANSF_STACK_SIZE) {
+
+        throw std::runtime_error("Transformation stack overflow!");
+    }
+    stack[stackSize ++] = model;
 }
 void Transformations::pop() {
 
-    model = stack.top();
-    stack.pop();
+    if(stackSize == 0) {
+
+        throw std::runtime_error("Transformation stack underflow!");
+    }
+    model = stack[-- stackSize];
 }
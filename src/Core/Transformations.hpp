@@ -5,10 +5,9 @@
 #define __TRANSFORMATIONS_H__
 
 #include "Types.hpp"
-#include "Shader.hpp"
 
-#include <vector>
-#include <stack>
+// Maximum depth of the model stack
+#define TRANSF_STACK_SIZE 32
 
 // Transformations class
 class Transformations {
@@ -18,21 +17,21 @@ private:
     // Viewport
     Vector2 viewport;
 
-    // Matrices
-    Matrix3 view;
-    Matrix3 model;
-    Matrix3 operand;
+    // Transformations
+    Affine2 view;
+    Affine2 model;
 
     // Model stack
-    std::stack<Matrix3> stack;
+    Affine2 stack[TRANSF_STACK_SIZE];
+    int stackSize;
 
 protected:
 
     // Framebuffer size
     Vector2 fbSize;
 
-    // Pass transformations to shader
-    void passToShader(Shader* s);
+    // Get the combined view & model transformation
+    Affine2 getCombined();
 
 public:
 
@@ -52,7 +51,7 @@ public:
     // Stack operations
     void push();
     void pop();
-    inline void resetStack() { stack.empty(); }
+    inline void resetStack() { stackSize = 0; }
 
     // Getters
     inline Vector2 getViewport() {return viewport;}
@@ -3,7 +3,10 @@
 
 #include "Transition.hpp"
 
+#include "MathExt.hpp"
+
 #include <cstdlib>
+#include <cmath>
 
 // Constants
 static const float MAX_TIME = 60.0f;
@@ -13,6 +16,7 @@ static const float MAX_TIME = 60.0f;
 Transition::Transition() {
 
     timer = 0;
+    oldTimer = 0;
     speed = 0;
     col = Color(0, 0, 0);
     mode = FadeOut;
@@ -27,6 +31,7 @@ void Transition::update(float tm) {
     if (!active) return;
 
     // Update timer
+    oldTimer = timer;
     timer -= speed * tm;
     if(timer <= 0.0f) {      
 
@@ -39,6 +44,7 @@ void Transition::update(float tm) {
 
             mode = FadeOut;
             timer = MAX_TIME;
+            oldTimer = timer;
         }
         // If out
         else  {
@@ -55,7 +61,8 @@ void Transition::draw(Graphics* g) {
     if(!active) return;
 
     // Compute fade value
-    float t = 1.0f / MAX_TIME * timer;
+    float t = 1.0f / MAX_TIME * 
+        fmaxf(0.0f, lerp(oldTimer, timer, g->getInterpolation()));
     if(mode == FadeIn) {
 
         t = 1.0f - t;
@@ -84,6 +91,7 @@ void Transition::activate(int mode, float speed,
     this->cb = cb;
 
     timer = MAX_TIME;
+    oldTimer = timer;
     active = true;
 }
 void Transition::activate(int mode, float speed, TransitionCallback cb) {
@@ -26,6 +26,8 @@ private:
     bool active;
     // Timer
     float timer;
+    // Timer before the latest step
+    float oldTimer;
     // Color
     Color col;
     // Speed
@@ -0,0 +1,66 @@
+// Triple buffer
+// (c) 2019 Jani Nykänen
+
+#ifndef __TRIPLE_BUFFER_H__
+#define __TRIPLE_BUFFER_H__
+
+#include <atomic>
+
+// Lock-free triple buffer for passing snapshots from
+// one writer thread to one reader thread. The writer
+// never waits, and the reader always gets the latest
+// complete snapshot
+template <class T> class TripleBuffer {
+
+private:
+
+    // Flag telling the middle slot holds
+    // something the reader has not seen
+    static const int FRESH = 4;
+
+    // Slots
+    T slots[3];
+    // Index of the middle slot, plus the flag
+    std::atomic<int> middle;
+    // Slots owned by the writer & the reader
+    int write;
+    int read;
+
+public:
+
+    // Constructor
+    inline TripleBuffer() {
+
+        middle = 1;
+        write = 0;
+        read = 2;
+    }
+
+    // Get the slot to write to
+    inline T& getWriteSlot() { return slots[write]; }
+    // Publish the written slot
+    inline void publish() {
+
+        write = middle.exchange(write | FRESH) & 3;
+    }
+
+    // Fetch the latest snapshot. Returns false if
+    // nothing new has been published
+    inline bool fetch() {
+
+        if((middle.load() & FRESH) == 0)
+            return false;
+
+        read = middle.exchange(read) & 3;
+        return true;
+    }
+    // Get the snapshot fetched last. The reader
+    // owns it until the next fetch
+    inline T& getReadSlot() { return slots[read]; }
+
+    // Get any slot, once neither thread uses
+    // the buffer anymore
+    inline T& getSlot(int i) { return slots[i]; }
+};
+
+#endif // __TRIPLE_BUFFER_H__
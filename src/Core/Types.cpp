@@ -7,112 +7,139 @@
 
 #include <cmath>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
-// Matrix constructor
-Matrix3::Matrix3() {
+
+// Constructor
+Affine2::Affine2() {
 
     identity();
 }
 
 
 // Multiply
-Vector2 Matrix3::mul(Vector2 p) {
-
-    Vector2 ret;
-
-    ret.x = m11 * p.x + m21 * p.y + m31 * 1.0f;
-    ret.y = m12 * p.x + m22 * p.y + m32 * 1.0f;
+Vector2 Affine2::mul(Vector2 p) {
 
-    return ret;
+    return Vector2(a * p.x + c * p.y + tx, b * p.x + d * p.y + ty);
 }
-Matrix3 Matrix3::mul(Matrix3 M) {
+Affine2 Affine2::mul(const Affine2 &M) {
 
-    Matrix3 A;
+    Affine2 A;
 
-    A.m11 = m11 * M.m11 + m21 * M.m12 + m31 * M.m13;
-	A.m21 = m11 * M.m21 + m21 * M.m22 + m31 * M.m23;
-	A.m31 = m11 * M.m31 + m21 * M.m32 + m31 * M.m33;
-
-	A.m12 = m12 * M.m11 + m22 * M.m12 + m32 * M.m13;
-	A.m22 = m12 * M.m21 + m22 * M.m22 + m32 * M.m23;
-	A.m32 = m12 * M.m31 + m22 * M.m32 + m32 * M.m33;
-
-	A.m13 = m13 * M.m11 + m23 * M.m12 + m33 * M.m13;
-	A.m23 = m13 * M.m21 + m23 * M.m22 + m33 * M.m23;
-	A.m33 = m13 * M.m31 + m23 * M.m32 + m33 * M.m33;
+    A.a = a * M.a + c * M.b;
+    A.b = b * M.a + d * M.b;
+    A.c = a * M.c + c * M.d;
+    A.d = b * M.c + d * M.d;
+    A.tx = a * M.tx + c * M.ty + tx;
+    A.ty = b * M.tx + d * M.ty + ty;
 
     return A;
 }
 
 
-// Set to identity matrix
-Matrix3 Matrix3::identity() {
+// Set to the identity transformation
+Affine2 Affine2::identity() {
 
-    m11 = 1.0f; m21 = 0; m31 = 0;
-	m12 = 0; m22 = 1.0f; m32 = 0;
-	m13 = 0; m23 = 0; m33 = 1.0f;
+    a = 1.0f; c = 0; tx = 0;
+    b = 0; d = 1.0f; ty = 0;
 
     return *this;
 }
 
 
-// Set to rotation matrix
-Matrix3 Matrix3::rotate(float angle) {
+// Ortho 2D projection
+Affine2 Affine2::ortho2D(float left, float right, 
+        float bottom, float top) {
 
-    float s = (float)sin(angle);
-    float c = (float)cos(angle);
+    float w = right - left;
+    float h = top - bottom;
 
-	m11 = c; m21 =-s; m31 = 0;
-	m12 = s; m22 = c; m32 = 0;
-	m13 = 0; m23 = 0; m33 = 1.0f;
+    a = 2.0f / w; c = 0; tx = -(right+left)/w;
+    b = 0; d = -2.0f / h; ty = (top+bottom)/h;
 
     return *this;
 }
 
 
-// Scale
-Matrix3 Matrix3::scale(float x, float y) {
-
-    m11 = x; m21 = 0; m31 = 0;
-	m12 = 0; m22 = y; m32 = 0;
-	m13 = 0; m23 = 0; m33 = 1.0f;
+// Translate
+void Affine2::translate(float x, float y) {
 
-    return *this;
+    tx += a * x + c * y;
+    ty += b * x + d * y;
 }
 
 
-// Translate
-Matrix3 Matrix3::translate(float x, float y) {
-
-    m11 = 1.0f; m21 = 0; m31 = x;
-	m12 = 0; m22 = 1.0f; m32 = y;
-	m13 = 0; m23 = 0; m33 = 1.0f;
+// Rotate
+void Affine2::rotate(float angle) {
 
-    return *this;
+    float s = (float)sin(angle);
+    float co = (float)cos(angle);
+
+    float na = a * co + c * s;
+    float nb = b * co + d * s;
+    c = c * co - a * s;
+    d = d * co - b * s;
+    a = na;
+    b = nb;
 }
 
 
-// Ortho 2D projection
-Matrix3 Matrix3::ortho2D(float left, float right, 
-        float bottom, float top) {
+// Scale
+void Affine2::scale(float x, float y) {
 
-    float w = right - left;
-	float h = top - bottom;
+    a *= x; b *= x;
+    c *= y; d *= y;
+}
 
-	m11 = 2.0f / w; m21 = 0; m31 = -(right+left)/w;
-	m12 = 0; m22 = -2.0f / h; m32 = (top+bottom)/h;
-	m13 = 0; m23 = 0; m33 = 1.0f;
 
-    return *this;
+// Transform the corners of a rectangle
+void Affine2::transformRect(float x, float y, float w, float h, 
+    float* out, int stride) {
+
+#ifdef __SSE__
+    // All four corners at once
+    __m128 xs = _mm_set_ps(x, x+w, x+w, x);
+    __m128 ys = _mm_set_ps(y+h, y+h, y, y);
+
+    __m128 ox = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), xs), 
+                   _mm_mul_ps(_mm_set1_ps(c), ys)),
+        _mm_set1_ps(tx));
+    __m128 oy = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b), xs), 
+                   _mm_mul_ps(_mm_set1_ps(d), ys)),
+        _mm_set1_ps(ty));
+
+    __m128 lo = _mm_unpacklo_ps(ox, oy);
+    __m128 hi = _mm_unpackhi_ps(ox, oy);
+    _mm_storel_pi((__m64*)out, lo);
+    _mm_storeh_pi((__m64*)(out + stride), lo);
+    _mm_storel_pi((__m64*)(out + stride*2), hi);
+    _mm_storeh_pi((__m64*)(out + stride*3), hi);
+#else
+    // The edges are shared, so compute them once
+    float ax = a * x + tx, aw = a * w;
+    float bx = b * x + ty, bw = b * w;
+    float cy = c * y, ch = c * h;
+    float dy = d * y, dh = d * h;
+
+    out[0] = ax + cy; out[1] = bx + dy;
+    out += stride;
+    out[0] = ax + aw + cy; out[1] = bx + bw + dy;
+    out += stride;
+    out[0] = ax + aw + cy + ch; out[1] = bx + bw + dy + dh;
+    out += stride;
+    out[0] = ax + cy + ch; out[1] = bx + dy + dh;
+#endif
 }
 
 
-// To array
-float* Matrix3::toArray() {
-
-    arr[0] = m11; arr[1] = m12; arr[2] = m13;
-    arr[3] = m21; arr[4] = m22; arr[5] = m23;
-    arr[6] = m31; arr[7] = m32; arr[8] = m33;
+// To a column-major 3x3 array
+void Affine2::toArray(float* out) {
 
-    return arr;
+    out[0] = a; out[1] = b; out[2] = 0;
+    out[3] = c; out[4] = d; out[5] = 0;
+    out[6] = tx; out[7] = ty; out[8] = 1.0f;
 }
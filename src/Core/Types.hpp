@@ -80,41 +80,45 @@ struct Color {
     }
 };
 
-// Fixed point 3x3 matrix
-class Matrix3 {
+// 2D affine transformation: a 3x3 matrix without
+// the constant bottom row. Maps (x, y) to
+// (a*x + c*y + tx, b*x + d*y + ty)
+class Affine2 {
 
-private:
+public:
 
     // Components
-    float m11, m21, m31,
-        m12, m22, m32,
-        m13, m23, m33;
-    float arr[3*3];
-
-public:
+    float a, b, c, d;
+    float tx, ty;
 
     // Constructor
-    Matrix3();
+    Affine2();
 
     // Multiply
     Vector2 mul(Vector2 p);
-    Matrix3 mul(Matrix3 M);
-
-    // Set to the identity matrix
-    Matrix3 identity();
-    // Set to rotation matrix
-    Matrix3 rotate(float angle);
-    // Scale
-    Matrix3 scale(float x, float y);
-    // Translate
-    Matrix3 translate(float x, float y);
+    Affine2 mul(const Affine2 &M);
+
+    // Set to the identity transformation
+    Affine2 identity();
     // Ortho 2D projection
-    Matrix3 ortho2D(float left, float right, 
+    Affine2 ortho2D(float left, float right, 
         float bottom, float top);
 
-    // To array
-    float* toArray();
+    // Apply a transformation after the current
+    // one, like multiplying from the right
+    void translate(float x, float y);
+    void rotate(float angle);
+    void scale(float x, float y);
+
+    // Transform the corners of a rectangle, in the
+    // order top-left, top-right, bottom-right,
+    // bottom-left. Each corner is written to out,
+    // advancing by stride floats
+    void transformRect(float x, float y, float w, float h, 
+        float* out, int stride);
+
+    // To a column-major 3x3 array
+    void toArray(float* out);
 };
 
 #endif // __TYPES_H__
- 
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "Utility.hpp"
 
 #include <sstream>
+#include <chrono>
+#include <cstdio>
 
 // Integer to string
 std::string intToString(int a) {
@@ -21,3 +23,39 @@ int strToInt(std::string str) {
     std::istringstream ( str ) >> ret;
     return ret;
 }
+
+
+// Monotonic time in nanoseconds
+int64 getNanoTime() {
+
+    return (int64)std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// Read a whole file
+bool readFile(std::string path, std::vector<uint8> &out) {
+
+    out.clear();
+
+    FILE* f = fopen(path.c_str(), "rb");
+    if(f == NULL) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    bool ok = size >= 0;
+    if(size > 0) {
+
+        out.resize(size);
+        if(fread(&out[0], 1, size, f) != (size_t)size) {
+
+            out.clear();
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    return ok;
+}
@@ -5,6 +5,9 @@
 #define __UTILITY_H__
 
 #include <string>
+#include <vector>
+
+#include "Types.hpp"
 
 // Integer to string
 std::string intToString(int a);
@@ -12,4 +15,11 @@ std::string intToString(int a);
 // String to integer
 int strToInt(std::string str);
 
+// Monotonic time in nanoseconds
+int64 getNanoTime();
+
+// Read a whole file. Returns false if
+// it could not be read
+bool readFile(std::string path, std::vector<uint8> &out);
+
 #endif // __UTILITY_H__
@@ -0,0 +1,121 @@
+// Write PNG
+// (c) 2019 Jani Nykänen
+
+#include "WritePNG.hpp"
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+
+// Maximum size of a stored deflate block
+static const unsigned int MAX_BLOCK = 65535;
+
+
+// Compute CRC32 of a chunk
+static unsigned int crc32(const unsigned char* data, int len, 
+    unsigned int crc = 0xFFFFFFFF) {
+
+    for(int i = 0; i < len; ++ i) {
+
+        crc ^= data[i];
+        for(int k = 0; k < 8; ++ k) {
+
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+
+// Push a big-endian 32-bit integer
+static void pushInt(std::vector<unsigned char> &out, unsigned int v) {
+
+    out.push_back((v >> 24) & 0xFF);
+    out.push_back((v >> 16) & 0xFF);
+    out.push_back((v >> 8) & 0xFF);
+    out.push_back(v & 0xFF);
+}
+
+
+// Push a chunk
+static void pushChunk(std::vector<unsigned char> &out, const char* type,
+    const std::vector<unsigned char> &data) {
+
+    pushInt(out, (unsigned int)data.size());
+
+    int start = (int)out.size();
+    out.insert(out.end(), type, type+4);
+    out.insert(out.end(), data.begin(), data.end());
+
+    pushInt(out, crc32(&out[start], (int)out.size()-start) ^ 0xFFFFFFFF);
+}
+
+
+// Write RGBA data to a PNG file
+void writePNG(std::string path, const unsigned char* data, 
+    int width, int height) {
+
+    const unsigned char SIGNATURE[] = {137,80,78,71,13,10,26,10};
+
+    int row = width*4;
+    std::vector<unsigned char> out (SIGNATURE, SIGNATURE+8);
+    std::vector<unsigned char> chunk;
+
+    // Header: size, 8-bit RGBA, no interlacing
+    pushInt(chunk, width);
+    pushInt(chunk, height);
+    chunk.push_back(8);
+    chunk.push_back(6);
+    chunk.push_back(0);
+    chunk.push_back(0);
+    chunk.push_back(0);
+    pushChunk(out, "IHDR", chunk);
+
+    // Rows, each prefixed with filter type 0
+    std::vector<unsigned char> raw;
+    raw.reserve((row+1)*height);
+    for(int y = 0; y < height; ++ y) {
+
+        raw.push_back(0);
+        raw.insert(raw.end(), data + y*row, data + (y+1)*row);
+    }
+
+    // Zlib stream made of stored blocks
+    chunk.clear();
+    chunk.push_back(0x78);
+    chunk.push_back(0x01);
+    unsigned int a = 1, b = 0;
+    unsigned int len;
+    for(size_t i = 0; i < raw.size() || i == 0; i += MAX_BLOCK) {
+
+        len = (unsigned int)std::min((size_t)MAX_BLOCK, raw.size()-i);
+        chunk.push_back(i+len >= raw.size() ? 1 : 0);
+        chunk.push_back(len & 0xFF);
+        chunk.push_back((len >> 8) & 0xFF);
+        chunk.push_back(~len & 0xFF);
+        chunk.push_back((~len >> 8) & 0xFF);
+        chunk.insert(chunk.end(), raw.begin()+i, raw.begin()+i+len);
+
+        for(unsigned int j = 0; j < len; ++ j) {
+
+            a = (a + raw[i+j]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    pushInt(chunk, (b << 16) | a);
+    pushChunk(out, "IDAT", chunk);
+
+    chunk.clear();
+    pushChunk(out, "IEND", chunk);
+
+    // Write to file
+    FILE* f = fopen(path.c_str(), "wb");
+    if(f == NULL) {
+
+        throw std::runtime_error("Failed to create a file in " + path);
+    }
+    fwrite(&out[0], 1, out.size(), f);
+    fclose(f);
+}
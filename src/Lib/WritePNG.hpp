@@ -0,0 +1,14 @@
+// Write PNG
+// (c) 2019 Jani Nykänen
+
+#ifndef __WRITE_PNG_H__
+#define __WRITE_PNG_H__
+
+#include <string>
+
+// Write RGBA data to a PNG file. The image data
+// is stored without compression
+void writePNG(std::string path, const unsigned char* data, 
+    int width, int height);
+
+#endif // __WRITE_PNG_H__
@@ -59,8 +59,8 @@ void Menu::update(EventManager* evMan) {
 
     // Check key press
     MenuButton b;
-    if(vpad->getButton("accept") == State::Pressed ||
-       vpad->getButton("start") == State::Pressed) {
+    if(vpad->getButton(NAME_ID("accept")) == State::Pressed ||
+       vpad->getButton(NAME_ID("start")) == State::Pressed) {
 
         // Call callback function, if any
         b = buttons[cursorPos];
@@ -130,9 +130,9 @@ void Menu::setText(int p, std::string text) {
 void initGlobalMenu(AssetPack* assets) {
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
     // Get samples
-    sSelect = assets->getSample("select");
-    sAccept = assets->getSample("accept");
+    sSelect = assets->getSample(NAME_ID("select"));
+    sAccept = assets->getSample(NAME_ID("accept"));
 }
 
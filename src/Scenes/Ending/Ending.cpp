@@ -49,11 +49,11 @@ void Ending::init() {
     trans = evMan->getTransition();
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
-    bmpTrophy = assets->getBitmap("trophy");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
+    bmpTrophy = assets->getBitmap(NAME_ID("trophy"));
     // Get samples
-    sAccept = assets->getSample("accept");
-    sHit = assets->getSample("hit");
+    sAccept = assets->getSample(NAME_ID("accept"));
+    sHit = assets->getSample(NAME_ID("hit"));
 
     // Set ending text
     endingText[0] = std::string(ENDING1);
@@ -105,8 +105,8 @@ void Ending::update(float tm) {
             endingTimer = 0.0f;
     }
     // If enter or "accept" pressed, quit
-    else if(vpad->getButton("start") == State::Pressed ||
-        vpad->getButton("accept") == State::Pressed) {
+    else if(vpad->getButton(NAME_ID("start")) == State::Pressed ||
+        vpad->getButton(NAME_ID("accept")) == State::Pressed) {
 
         // Play sound
         audio->playSample(sAccept, 0.45f);
@@ -7,6 +7,8 @@
 #include "../../Core/Tilemap.hpp"
 #include "../../Core/SceneManager.hpp"
 #include "../../Core/Utility.hpp"
+#include "../../Core/Profiler.hpp"
+#include "../../Core/Trace.hpp"
 
 #include "../StageMenu/StageMenu.hpp"
 
@@ -77,8 +79,10 @@ void Game::drawStageClear(Graphics* g) {
 // Hard reset
 void Game::hardReset(StageInfo* sinfo) {
 
+    TraceScope trace("Game::hardReset");
+
     // (Re)initialize stage
-    stage = Stage(sinfo->tmap);
+    stage.reInit(sinfo->tmap);
     // Parse map for objects
     workers = std::vector<Worker> ();
     stage.parseMap(comm);
@@ -224,15 +228,15 @@ void Game::init() {
     gref = this;
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
     // Get samples
-    sWalk = assets->getSample("walk");
-    sTransform = assets->getSample("transform");
-    sAccept = assets->getSample("accept");
-    sPause = assets->getSample("pause");
-    sSuccess = assets->getSample("success");
+    sWalk = assets->getSample(NAME_ID("walk"));
+    sTransform = assets->getSample(NAME_ID("transform"));
+    sAccept = assets->getSample(NAME_ID("accept"));
+    sPause = assets->getSample(NAME_ID("pause"));
+    sSuccess = assets->getSample(NAME_ID("success"));
     // Get music
-    mTheme = assets->getMusic("theme");
+    mTheme = assets->getMusic(NAME_ID("theme"));
 
     // Get transition
     trans = evMan->getTransition();
@@ -287,6 +291,15 @@ void Game::update(float tm) {
 
     AudioManager* audio = evMan->getAudioManager();
 
+    // Store the state for interpolation. Done before
+    // anything else, so whatever is not updated this
+    // step stays still
+    for(int i = 0; i < workers.size(); ++ i) {
+
+        workers[i].storeState();
+    }
+    stage.storeState();
+
     // If fading, wait until it's over
     if(trans->isActive())
         return;
@@ -305,7 +318,7 @@ void Game::update(float tm) {
         return;
     }
     // TEMP
-    else if(vpad->getButton("debug") == State::Pressed) {
+    else if(vpad->getButton(NAME_ID("debug")) == State::Pressed) {
 
         endMenu.activate();
     }
@@ -327,8 +340,8 @@ void Game::update(float tm) {
     else {
 
         // Activate pause
-        if(vpad->getButton("start") == State::Pressed ||
-           vpad->getButton("cancel") == State::Pressed) {
+        if(vpad->getButton(NAME_ID("start")) == State::Pressed ||
+           vpad->getButton(NAME_ID("cancel")) == State::Pressed) {
 
             // Play sound
             audio->playSample(sPause, 0.40f);
@@ -339,7 +352,7 @@ void Game::update(float tm) {
     }
 
     // Reset
-    if(vpad->getButton("reset") == State::Pressed) {
+    if(vpad->getButton(NAME_ID("reset")) == State::Pressed) {
 
         // Play sound
         audio->playSample(sAccept, 0.45f);
@@ -461,9 +474,47 @@ void Game::onChange(void* param) {
 }
 
 
+// Called when a file has changed
+void Game::onFileChange(std::string path) {
+
+    // The stage menu has reloaded the map
+    // already, restart if it is this one
+    Tilemap* tmap = stage.getTilemap();
+    if(tmap == NULL || tmap->getPath() != path)
+        return;
+
+    stage.reInit(tmap);
+    // Closes the menus too, as a restart would
+    reset();
+    hud.setMoveTarget(stage.getMoveTarget());
+}
+
+
+// Is the game running (and not paused)
+bool Game::isAnimating() {
+
+    // The end menu has an animated background
+    return endMenu.isActive() || 
+        !(pause.isActive() || settings.isActive());
+}
+
+
+// Copy the scene for drawing
+Scene* Game::copyState(Scene* dst) {
+
+    Game* g = (Game*)copyScene(this, dst);
+    // The copy must draw its own workers
+    g->comm = Communicator(g);
+
+    return g;
+}
+
+
 // Draw workers
 void Game::drawWorkers(Graphics* g) {
 
+    ProfileScope scope("Game::drawWorkers");
+
     // Draw workers
     for(int i = 0; i < workers.size(); ++ i) {
 
@@ -95,6 +95,12 @@ public:
     // Called when the scene is changed
     // to this scene
     void onChange(void* param =NULL);
+    // Called when a file has changed
+    void onFileChange(std::string path);
+    // Is the game running (and not paused)
+    bool isAnimating();
+    // Copy the scene for drawing
+    Scene* copyState(Scene* dst);
     
     // Draw workers
     void drawWorkers(Graphics* g);
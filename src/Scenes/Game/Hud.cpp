@@ -4,6 +4,7 @@
 #include "Hud.hpp"
 
 #include "../../Core/Utility.hpp"
+#include "../../Core/Profiler.hpp"
 
 #include <sstream>
 #include <iostream>
@@ -13,7 +14,7 @@
 Hud::Hud(AssetPack* assets) {
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
 
     // Set defaults
     timer = 0;
@@ -43,6 +44,8 @@ void Hud::draw(Graphics* g) {
     const float TIME_Y = 72;
     const float STAR_Y = 72;
 
+    ProfileScope scope("Hud::draw");
+
     // Draw stage text
     g->setColor();
     g->drawText(bmpFont, "Stage " + intToString(stageID), 
@@ -44,7 +44,7 @@ void PauseMenu::update(EventManager* evMan, bool esc) {
 
     // Quit with escape, if enabled
     if(esc
-    && evMan->getController()->getButton("cancel") == State::Pressed) {
+    && evMan->getController()->getButton(NAME_ID("cancel")) == State::Pressed) {
 
         // Play sound
         evMan->getAudioManager()->playSample(sReject, 0.40f);
@@ -117,5 +117,5 @@ void PauseMenu::setButtonText(int button,
 void initGlobalPauseMenu(AssetPack* assets) {
 
     // Get samples
-    sReject = assets->getSample("reject");
+    sReject = assets->getSample(NAME_ID("reject"));
 }
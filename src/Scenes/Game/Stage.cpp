@@ -4,20 +4,25 @@
 #include "Stage.hpp"
 
 #include "../../Core/Utility.hpp"
+#include "../../Core/Profiler.hpp"
+#include "../../Core/MathExt.hpp"
 
 // Bitmaps
 static Bitmap* bmpWall;
 static Bitmap* bmpBorders;
 static Bitmap* bmpCog;
 
+// Static content ids given so far
+static int staticCount = 0;
+
 
 // Initialize global data
 void initGlobalStage(AssetPack* assets) {
 
     // Get assets
-    bmpWall = assets->getBitmap("wall");
-    bmpBorders = assets->getBitmap("borders");
-    bmpCog = assets->getBitmap("cog");
+    bmpWall = assets->getBitmap(NAME_ID("wall"));
+    bmpBorders = assets->getBitmap(NAME_ID("borders"));
+    bmpCog = assets->getBitmap(NAME_ID("cog"));
 }
 
 
@@ -40,6 +45,37 @@ void Stage::drawWalls(Graphics* g) {
 
     int x, y;
     int px, py;
+
+    // Shadows only reach the tiles to the right and
+    // below, which are drawn later anyway, so we can
+    // draw every shadow first, then every tile and
+    // finally the borders. This way each pass uses
+    // a single texture
+    g->setColor(0.30f,0.15f,0.10f);
+    for(int i = 0; i < width*height; ++ i) {
+
+        if(data[i] != 1) 
+            continue;
+
+        px = (i % width)*s;
+        py = (i / width)*s;
+        g->fillRect(px+SHADOW, py+SHADOW,s,s);
+    }
+
+    // Draw wall tiles
+    g->setColor();
+    for(int i = 0; i < width*height; ++ i) {
+
+        if(data[i] != 1) 
+            continue;
+
+        px = (i % width)*s;
+        py = (i / width)*s;
+        g->drawBitmap(bmpWall, 0,0, 128, 128, px, py);
+    }
+
+    // Draw black borders
+    g->setColor(0, 0, 0);
     for(int i = 0; i < width*height; ++ i) {
 
         if(data[i] != 1) 
@@ -51,16 +87,6 @@ void Stage::drawWalls(Graphics* g) {
         px = x*s;
         py = y*s;
 
-        // Draw shadow
-        g->setColor(0.30f,0.15f,0.10f);
-        g->fillRect(px+SHADOW, py+SHADOW,s,s);
-
-        // Draw wall tile
-        g->setColor();
-        g->drawBitmap(bmpWall, 0,0, 128, 128, px, py);
-        
-        // Draw black borders
-        g->setColor(0, 0, 0);
         // Right
         if(getTile(x+1, y) != 1)
              g->fillRect(px+s-BORDER, py, BORDER, s);
@@ -168,17 +194,43 @@ void Stage::drawShadow(Graphics* g) {
 }
 
 
+// Record the static layer
+void Stage::buildStaticLayer(Graphics* g) {
+
+    g->beginMesh(&staticLayer.mesh);
+
+    // Draw shadow
+    drawShadow(g);
+
+    // Clear to black
+    g->setColor(0.55f, 0.35f, 0.20f);
+    g->fillRect(0, 0, baseWidth, baseHeight);
+
+    // Draw walls
+    g->setColor();
+    drawWalls(g);
+
+    // Draw floor
+    drawFloor(g);
+
+    // Draw borders
+    g->setColor();
+    drawBorders(g);
+
+    g->endMesh();
+
+    staticLayer.id = staticId;
+}
+
+
 // Draw a single cog
 void Stage::drawCog(Graphics* g, float x, float y, 
     float scale, float angle) {
 
-    g->push();
-    g->translate(x, y);
-    g->rotate(angle);
-    g->scale(scale, scale);
-    g->useTransf();
-    g->drawBitmap(bmpCog,-128,-128,256,256);
-    g->pop();
+    g->drawInstance(bmpCog, 0, 0, 
+        bmpCog->getWidth(), bmpCog->getHeight(),
+        -128, -128, 256, 256, 
+        x, y, angle, scale);
 }
 
 
@@ -193,6 +245,7 @@ void Stage::drawCogs(Graphics* g) {
     const float SHADOW_ALPHA = 0.5f;
 
     Vector2 view = g->getViewport();
+    float angle = lerp(oldCogAngle, cogAngle, g->getInterpolation());
 
     for(int i = 1; i >= 0; -- i) {
 
@@ -203,13 +256,13 @@ void Stage::drawCogs(Graphics* g) {
 
         // Bottom right
         drawCog(g, view.x + i *SHADOW_X, view.y + i*SHADOW_Y, 
-            BOTTOM_RIGHT, cogAngle);
+            BOTTOM_RIGHT, angle);
         // Bottom left
         drawCog(g,  SHADOW_X, view.y +  i *SHADOW_Y, 
-            BOTTOM_LEFT, -cogAngle);
+            BOTTOM_LEFT, -angle);
         // Top right
         drawCog(g, view.x+ i *SHADOW_X,  i *SHADOW_X, 
-            TOP_RIGHT, -cogAngle);
+            TOP_RIGHT, -angle);
     }
 
 }
@@ -235,13 +288,18 @@ void Stage::init() {
 
     // Set defaults
     cogAngle = 0.0f;
+    oldCogAngle = cogAngle;
+
+    // The static layer is recorded on the next draw
+    staticId = ++ staticCount;
 }
 
 
 // Constructors
 Stage::Stage() {
 
-    // ...
+    tmap = NULL;
+    staticId = 0;
 }
 Stage::Stage(Tilemap* tmap) {
 
@@ -375,9 +433,18 @@ void Stage::update(EventManager* evMan, float tm) {
 }
 
 
+// Store the state for interpolation
+void Stage::storeState() {
+
+    oldCogAngle = cogAngle;
+}
+
+
 // Draw
 void Stage::draw(Graphics* g, Communicator &comm) {
 
+    ProfileScope scope("Stage::draw");
+
     // Get viewport
     Vector2 view = g->getViewport();
 
@@ -391,23 +458,13 @@ void Stage::draw(Graphics* g, Communicator &comm) {
     g->translate(-baseWidth/2, -baseHeight/2);
     g->useTransf();
 
-    // Draw shadow
-    drawShadow(g);
-
-    // Clear to black
-    g->setColor(0.55f, 0.35f, 0.20f);
-    g->fillRect(0, 0, baseWidth, baseHeight);
-
-    // Draw walls
-    g->setColor();
-    drawWalls(g);
+    // Draw the static layer
+    if(staticLayer.id != staticId) {
 
-    // Draw floor
-    drawFloor(g);
-
-    // Draw borders
+        buildStaticLayer(g);
+    }
     g->setColor();
-    drawBorders(g);
+    g->drawMesh(&staticLayer.mesh);
 
     // Draw workers
     comm.drawWorkers(g);
@@ -440,5 +497,5 @@ int Stage::getSolidValue(int x, int y) {
 // Get move target
 int Stage::getMoveTarget() {
 
-    return strToInt(tmap->getProp("moves"));
+    return tmap->getMoveTarget();
 }
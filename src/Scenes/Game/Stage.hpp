@@ -16,6 +16,22 @@
 // Constants
 #define BASE_TILE_SIZE 128.0f
 
+// Recorded static layer of a stage. It is not
+// copied with the stage, every copy records its own
+struct StaticLayer {
+
+    Mesh mesh;
+    // Id of the content recorded, 0 if none
+    int id;
+
+    // Constructors
+    inline StaticLayer() { id = 0; }
+    inline StaticLayer(const StaticLayer &l) { id = 0; }
+    // Assignment keeps the layer recorded
+    inline StaticLayer& operator=(const StaticLayer &l) { return *this; }
+};
+
+
 // Stage class
 class Stage {
 
@@ -41,6 +57,14 @@ private:
 
     // Cog angle
     float cogAngle;
+    // Cog angle before the latest step
+    float oldCogAngle;
+
+    // Static layer (walls, floor, borders...)
+    StaticLayer staticLayer;
+    // Id of the static content, new every
+    // time the stage is (re)initialized
+    int staticId;
 
     // Get a tile
     int getTile(int x, int y);
@@ -53,6 +77,8 @@ private:
     void drawBorders(Graphics* g);
     // Draw shadow
     void drawShadow(Graphics* g);
+    // Record the static layer
+    void buildStaticLayer(Graphics* g);
 
     // Draw a single cog
     void drawCog(Graphics* g, float x, float y, 
@@ -79,6 +105,8 @@ public:
 
     // Update
     void update(EventManager* evMan, float tm);
+    // Store the state for interpolation
+    void storeState();
     // Draw
     void draw(Graphics* g, Communicator &comm);
 
@@ -89,6 +117,8 @@ public:
 
     // Get move target
     int getMoveTarget();
+    // Get the tilemap, NULL if none
+    inline Tilemap* getTilemap() { return tmap; }
 };
 
 // Initialize global data
@@ -5,6 +5,8 @@
 
 #include "Stage.hpp"
 
+#include "../../Core/MathExt.hpp"
+
 #include <cmath>
 #include <cstdlib>
 #include <stdio.h>
@@ -21,7 +23,7 @@ static Bitmap* bmpWorker;
 void initGlobalWorker(AssetPack* assets) {
 
     // Get bitmaps
-    bmpWorker = assets->getBitmap("worker");
+    bmpWorker = assets->getBitmap(NAME_ID("worker"));
 }
 
 
@@ -255,12 +257,14 @@ Worker::Worker(Point p, int color, bool sleeping, bool isCog) {
     pos = p;
     vpos.x = p.x * BASE_TILE_SIZE;
     vpos.y = p.y * BASE_TILE_SIZE;
+    oldVpos = vpos;
 
     // Set params
     this->color = color;
     this->sleeping = sleeping;
     this->isCog = isCog;
     angle = 0.0f;
+    oldAngle = angle;
 
     // Set defaults
     moving = false;
@@ -295,6 +299,14 @@ Worker::Worker(Point p, int color, bool sleeping, bool isCog) {
 }
 
 
+// Store the state for interpolation
+void Worker::storeState() {
+
+    oldVpos = vpos;
+    oldAngle = angle;
+}
+
+
 // Update
 void Worker::update(EventManager* evMan, Stage* stage, 
     bool anyMoving,  float tm) {
@@ -324,49 +336,43 @@ void Worker::draw(Graphics* g) {
     const float TRANSF_SCALE = 1.5f;
     const int TRANSF_FRAMES = 3;
 
+    // Draw between the latest steps
+    float it = g->getInterpolation();
+    Vector2 p = lerp(oldVpos, vpos, it);
+    float rot = lerp(oldAngle, angle, it);
+
+    // Everything is drawn as instances, so all the
+    // workers can be drawn in one go
+    float cx = p.x+BASE_TILE_SIZE/2;
+    float cy = p.y+BASE_TILE_SIZE/2;
+
     if(isCog) {
 
         float t = transforming ? transfTimer / TRANSFORM_TIME : 0.0f;
 
-        g->push();
-        g->translate(vpos.x+BASE_TILE_SIZE/2, 
-            vpos.y+BASE_TILE_SIZE/2);
-        g->rotate(angle);
-        g->scale(COG_SCALE*(1-t), COG_SCALE*(1-t));
-        g->useTransf();
-
         // Draw cog
-        spr.draw(g, bmpWorker, 7, color*2+1, 
+        spr.drawInstance(g, bmpWorker, 7, color*2+1, 
             -BASE_TILE_SIZE/2,
-            -BASE_TILE_SIZE/2);
-
-        g->pop();
-        g->useTransf();
+            -BASE_TILE_SIZE/2,
+            cx, cy, rot, COG_SCALE*(1-t));
 
         // Draw transforming sprite
         if(transforming) {
 
             float s = 1.0f + (1.0f-t) * (TRANSF_SCALE-1.0f);
 
-            g->push();
-            g->translate(vpos.x+BASE_TILE_SIZE/2, 
-                vpos.y+BASE_TILE_SIZE/2);
-            g->scale(s, s);
-            g->useTransf();
-
             g->setColor(1,1,1, t);
-            spr.draw(g, bmpWorker,
+            spr.drawInstance(g, bmpWorker, 
+                spr.getFrame(), spr.getRow(),
+                -BASE_TILE_SIZE/2,
                 -BASE_TILE_SIZE/2,
-                -BASE_TILE_SIZE/2);
+                cx, cy, 0.0f, s);
             g->setColor();
-
-            g->pop();
-            g->useTransf();
-            
         }
 
         // Draw eyes/face
-        spr.draw(g, bmpWorker, 6, color*2+1, vpos.x, vpos.y);
+        spr.drawInstance(g, bmpWorker, 6, color*2+1, 
+            0, 0, p.x, p.y);
 
     }
     else {
@@ -374,27 +380,22 @@ void Worker::draw(Graphics* g) {
         // Draw rock
         if(color == -1) {
 
-            g->push();
-            g->translate(vpos.x+BASE_TILE_SIZE/2, 
-                vpos.y+BASE_TILE_SIZE/2);
-            g->rotate(angle);
-            g->useTransf();
-
             // Draw rock body
-            spr.draw(g, bmpWorker, 0,7, 
+            spr.drawInstance(g, bmpWorker, 0,7, 
                 -BASE_TILE_SIZE/2, 
-                -BASE_TILE_SIZE/2);
-            
-            g->pop();
-            g->useTransf();
+                -BASE_TILE_SIZE/2,
+                cx, cy, rot);
 
             // Draw sunglasses
-            spr.draw(g, bmpWorker, 1,7, vpos.x, vpos.y);
+            spr.drawInstance(g, bmpWorker, 1,7, 
+                0, 0, p.x, p.y);
         }
         else {
 
             // Draw ordinary worker
-            spr.draw(g, bmpWorker, vpos.x, vpos.y);
+            spr.drawInstance(g, bmpWorker, 
+                spr.getFrame(), spr.getRow(),
+                0, 0, p.x, p.y);
         }
     }
 }
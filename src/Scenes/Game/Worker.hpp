@@ -22,6 +22,8 @@ private:
     Point target;
     // Virtual position
     Vector2 vpos;
+    // Virtual position before the latest step
+    Vector2 oldVpos;
 
     // Move timer
     float moveTimer;
@@ -41,6 +43,8 @@ private:
 
     // Cog angle
     float angle;
+    // Cog angle before the latest step
+    float oldAngle;
 
     // Sprite
     Sprite spr;
@@ -73,6 +77,9 @@ public:
     inline Worker() {}
     Worker(Point p, int color, bool sleeping=false, bool isCog=false);
 
+    // Store the state for interpolation. Called
+    // every step, before anything is updated
+    void storeState();
     // Update
     void update(EventManager* evMan, Stage* stage,  
         bool anyMoving, float tm);
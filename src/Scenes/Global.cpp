@@ -5,6 +5,8 @@
 
 #include "../Menu.hpp"
 
+#include "../Core/Trace.hpp"
+
 #include <GLFW/glfw3.h>
 
 #include <cstdlib>
@@ -43,6 +45,16 @@ void Global::update(float tm) {
 
         evMan->toggleFullscreen();
     }
+    // 3) Write frame statistics
+    if(evMan->getKeyState(GLFW_KEY_F9) == State::Pressed) {
+
+        evMan->writeFrameStats();
+    }
+    // 4) Start or stop tracing
+    if(evMan->getKeyState(GLFW_KEY_F10) == State::Pressed) {
+
+        Trace::toggle();
+    }
 
     // Update transition
     trans->update(tm);
@@ -53,13 +65,34 @@ void Global::update(float tm) {
 // Draw scene
 void Global::draw(Graphics* g) {
 
-    // Draw transition
-   trans->draw(g);
+    // Draw transition, on top of everything
+    g->setLayer(DrawLayer::Overlay);
+    trans->draw(g);
 }
 
 
 
+// Is the transition running
+bool Global::isAnimating() {
+
+    return trans->isActive();
+}
+
+
 // Dispose scene
 void Global::dispose() {
 
 }
+
+
+// Copy the scene for drawing
+Scene* Global::copyState(Scene* dst) {
+
+    // The transition lives in the event manager,
+    // so the copy draws its own
+    Global* g = (Global*)copyScene(this, dst);
+    g->transState = *trans;
+    g->trans = &g->transState;
+
+    return g;
+}
@@ -15,6 +15,9 @@ private:
 
     // Transition
     Transition* trans;
+    // Copy of the transition, drawn
+    // by the copies of the scene
+    Transition transState;
 
 public:
 
@@ -26,6 +29,10 @@ public:
     void draw(Graphics* g);
     // Dispose scene
     void dispose();
+    // Is the transition running
+    bool isAnimating();
+    // Copy the scene & the transition for drawing
+    Scene* copyState(Scene* dst);
     
     // Get name
     inline std::string getName() {
@@ -37,7 +37,7 @@ void Intro::init() {
     trans = evMan->getTransition();
 
     // Get bitmaps
-    bmpCreator = assets->getBitmap("creator");
+    bmpCreator = assets->getBitmap(NAME_ID("creator"));
     
     // Set defaults
     cogAngle = 0.0f;
@@ -60,8 +60,8 @@ void Intro::update(float tm) {
     // Check if ready for transition
     GamePad* vpad = evMan->getController();
     if(timer >= WAIT_TIME || 
-       vpad->getButton("start") == State::Pressed ||
-       vpad->getButton("accept") == State::Pressed) {
+       vpad->getButton(NAME_ID("start")) == State::Pressed ||
+       vpad->getButton(NAME_ID("accept")) == State::Pressed) {
 
         trans->activate(FadeIn, 2.0f, cb_Title, Color(0.1f, 0.60f, 1.0f));
     }
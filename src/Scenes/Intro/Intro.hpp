@@ -38,6 +38,10 @@ public:
     void dispose();
     // On change
     void onChange(void* param=NULL);
+    // Copy the scene for drawing
+    inline Scene* copyState(Scene* dst) {
+        return copyScene(this, dst);
+    }
 
     // Get name
     inline std::string getName() {
@@ -4,6 +4,7 @@
 #include "Grid.hpp"
 
 #include "../../Core/Utility.hpp"
+#include "../../Core/MathExt.hpp"
 
 #include <cmath>
 
@@ -71,9 +72,29 @@ void Grid::computeCursorVpos() {
 bool Grid::updateCursor(float tm) {
 
     const float FLOAT_SPEED = 0.05f;
-    // Update floating
-    cfloatTimer += FLOAT_SPEED * tm;
-    cfloatTimer = (float)fmod(cfloatTimer, M_PI*2);
+
+    // Update floating. Once nothing else moves, it
+    // finishes the half lap & stops at the rest
+    // position, so that the menu can go idle
+    float next = cfloatTimer + FLOAT_SPEED * tm;
+    if(isMoving()) {
+
+        floatSettled = false;
+    }
+    else if(!floatSettled && 
+        floorf(next / M_PI) > floorf(cfloatTimer / M_PI)) {
+
+        next = floorf(next / M_PI) * M_PI;
+        floatSettled = true;
+    }
+    if(!floatSettled)
+        cfloatTimer = next;
+    if(cfloatTimer >= M_PI*2) {
+
+        // Keep the previous value on the same lap
+        cfloatTimer -= M_PI*2;
+        oldCfloatTimer -= M_PI*2;
+    }
 
     // Update timer
     bool ret = false;
@@ -103,12 +124,12 @@ Grid::Grid(AssetPack* assets, int w, int h,
         int blockw, int blockh, int xoff, int yoff) {
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
-    bmpBlocks = assets->getBitmap("blocks");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
+    bmpBlocks = assets->getBitmap(NAME_ID("blocks"));
 
     // Get samples
-    sSelect = assets->getSample("select");
-    sAccept = assets->getSample("accept");
+    sSelect = assets->getSample(NAME_ID("select"));
+    sAccept = assets->getSample(NAME_ID("accept"));
 
     // Store info
     width = w;
@@ -127,8 +148,11 @@ Grid::Grid(AssetPack* assets, int w, int h,
     ctarget = cpos;
     ctimer = 0.0f;
     cfloatTimer = 0.0f;
+    oldCfloatTimer = cfloatTimer;
+    floatSettled = false;
     page = 0;
     computeCursorVpos();
+    oldCvpos = cvpos;
 
     // Set block scales to default
     blockScale = std::vector<BlockScale> (width*height);
@@ -141,17 +165,29 @@ Grid::Grid(AssetPack* assets, int w, int h,
 }
 
 
+// Store the state for interpolation
+void Grid::storeState() {
+
+    oldCvpos = cvpos;
+    oldCfloatTimer = cfloatTimer;
+}
+
+
 // Update
 bool Grid::update(EventManager* evMan, GridCallback numberCb, float tm) {
 
     const float DELTA = 0.25f;
+    const float SELECTED_SCALE = 1.25f;
 
     // Audio manager
     AudioManager* audio = evMan->getAudioManager();
 
-    // Update block scales
+    // Update block scales, the one in the
+    // cursor position grows
     for(int i = 0; i < blockScale.size(); ++ i) {
 
+        blockScale[i].target = 
+            i == cpos.y*width+cpos.x ? SELECTED_SCALE : 1.0f;
         blockScale[i].update(tm);
     }
 
@@ -196,8 +232,8 @@ bool Grid::update(EventManager* evMan, GridCallback numberCb, float tm) {
     }
 
     // Check button press
-    bool pressed = vpad->getButton("start") == State::Pressed ||
-        vpad->getButton("accept") == State::Pressed;
+    bool pressed = vpad->getButton(NAME_ID("start")) == State::Pressed ||
+        vpad->getButton(NAME_ID("accept")) == State::Pressed;
 
     // TODO: To a different method
     if(pressed) {
@@ -214,6 +250,8 @@ bool Grid::update(EventManager* evMan, GridCallback numberCb, float tm) {
             cpos.y = 0;
             ctarget = cpos;
             updateCursor(0);
+            // Jump, do not interpolate
+            oldCvpos = cvpos;
 
             resetBlockScalings();
         }
@@ -225,6 +263,8 @@ bool Grid::update(EventManager* evMan, GridCallback numberCb, float tm) {
             cpos.y = height-1;
             ctarget = cpos;
             updateCursor(0);
+            // Jump, do not interpolate
+            oldCvpos = cvpos;
 
             resetBlockScalings();
         }
@@ -277,7 +317,6 @@ void Grid::draw(Graphics* g, float tx, float ty, std::vector<int>* completion) {
     float bh = blockSize.y + yoff;
 
     // Draw blocks
-    float nscale;
     float cx, cy;
     float s;
     float textScale;
@@ -289,17 +328,14 @@ void Grid::draw(Graphics* g, float tx, float ty, std::vector<int>* completion) {
 
         for(int x = 0; x < width; ++ x) {
 
-            nscale = 1.0f;
             if(cpos.x == x && cpos.y == y) {
 
-                nscale = 1.25f;
                 col = BRIGHTEN;
             }
             else {
 
                 col = DARKEN;
             }
-            blockScale[y*width+x].target = nscale;
             s = blockScale[y*width+x].scale;
 
             cx = dx + x*bw + bw/2;
@@ -315,18 +351,30 @@ void Grid::draw(Graphics* g, float tx, float ty, std::vector<int>* completion) {
             by = cval/2;
             by *= 128;
 
+            // Blocks at rest do not overlap the other numbers,
+            // so they go to an unordered layer that draws all
+            // the blocks with one instanced call & the numbers
+            // after them. A block scaled up covers its
+            // neighbours, so it goes above them with its number
+            if(s > 1.0f)
+                g->setLayer(DrawLayer::Default + 2);
+            else
+                g->setLayer(DrawLayer::Default + 1, false);
+
             // Draw block shadow
             g->setColor(0, 0, 0, SHADOW_ALPHA);
-            g->drawBitmap(bmpBlocks,bx,by,128,128,
-                cx - blockSize.x/2*s + BUTTON_SHADOW_X, 
-                cy - blockSize.y/2*s + BUTTON_SHADOW_Y,
-                blockSize.x*s, blockSize.y*s);
+            g->drawInstance(bmpBlocks,bx,by,128,128,
+                -blockSize.x/2, -blockSize.y/2,
+                blockSize.x, blockSize.y,
+                cx + BUTTON_SHADOW_X, cy + BUTTON_SHADOW_Y, 
+                0.0f, s);
 
             // Draw block
             g->setColor(col, col, col);
-            g->drawBitmap(bmpBlocks,bx,by,128,128,
-                cx - blockSize.x/2*s, cy - blockSize.y/2*s,
-                blockSize.x*s, blockSize.y*s);
+            g->drawInstance(bmpBlocks,bx,by,128,128,
+                -blockSize.x/2, -blockSize.y/2,
+                blockSize.x, blockSize.y,
+                cx, cy, 0.0f, s);
 
             if(cval > 0)
                 continue;
@@ -361,20 +409,54 @@ void Grid::draw(Graphics* g, float tx, float ty, std::vector<int>* completion) {
         }
     }
 
+    // Everything after the grid stays above
+    // the numbers
+    g->setLayer(DrawLayer::Foreground);
+
     g->pop();
     g->useTransf();
     g->setColor();
 
+    // Draw between the latest steps
+    float it = g->getInterpolation();
+    Vector2 p = lerp(oldCvpos, cvpos, it);
+
     // Compute cursor floating
-    float cf = (float)sin(cfloatTimer) * CURSOR_FLOAT_AMPLITUDE;
+    float cf = (float)sin(lerp(oldCfloatTimer, cfloatTimer, it)) 
+        * CURSOR_FLOAT_AMPLITUDE;
     // Draw cursor
     g->drawBitmap(bmpBlocks, 129, 129, 126, 126,
-        view.x/2 + cvpos.x + blockSize.x*CURSOR_TRANS_X, 
-        view.y/2 + cvpos.y + blockSize.y*CURSOR_TRANS_Y + cf, 
+        view.x/2 + p.x + blockSize.x*CURSOR_TRANS_X, 
+        view.y/2 + p.y + blockSize.y*CURSOR_TRANS_Y + cf, 
         blockSize.x, blockSize.y);
 }
 
 
+// Is the cursor or a block moving
+bool Grid::isMoving() {
+
+    if(ctimer > 0.0f)
+        return true;
+
+    for(int i = 0; i < blockScale.size(); ++ i) {
+
+        if(blockScale[i].scale != blockScale[i].target)
+            return true;
+    }
+    return false;
+}
+
+
+// Is the grid animating
+bool Grid::isAnimating() {
+
+    // The step that settled the floating still
+    // differs from the one before it
+    return isMoving() || !floatSettled || 
+        oldCfloatTimer != cfloatTimer;
+}
+
+
 // Get chosen stage index
 int Grid::getChoseStageIndex() {
     
@@ -414,6 +496,7 @@ void Grid::setCursorPos(int i) {
     ctarget = cpos;
 
     computeCursorVpos();
+    oldCvpos = cvpos;
 
     ctimer = 0.0f;
 }
@@ -67,8 +67,13 @@ private:
     float ctimer;
     // Cursor float timer
     float cfloatTimer;
+    float oldCfloatTimer;
+    // Has the floating stopped at the rest position
+    bool floatSettled;
     // Cursor position ("virtual")
     Vector2 cvpos;
+    // Cursor position before the latest step
+    Vector2 oldCvpos;
     // Page
     int page;
 
@@ -80,6 +85,8 @@ private:
 
     // Update cursor
     bool updateCursor(float tm);
+    // Is the cursor or a block moving
+    bool isMoving();
 
 public:
 
@@ -88,12 +95,18 @@ public:
     Grid(AssetPack* assets, int w, int h, 
         int blockw, int blockh, int xoff, int yoff);
 
+    // Store the state for interpolation
+    void storeState();
     // Update
     bool update(EventManager* evMan, GridCallback numberCb, float tm);
     // Draw
     void draw(Graphics* g, float tx=0, float ty=0, 
         std::vector<int>* completion=NULL);
 
+    // Is the cursor or a block moving, or the
+    // cursor floating not yet settled
+    bool isAnimating();
+
     // Get chosen stage index
     int getChoseStageIndex();
     // Is the selected tile special
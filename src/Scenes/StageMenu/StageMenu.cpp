@@ -10,6 +10,8 @@
 
 // File path
 static const char* FILE_PATH = "save.dat";
+// Stage path
+static const std::string MAP_PATH = "Assets/Tilemaps/New/";
 
 // Reference to self
 static StageMenu* smRef;
@@ -67,7 +69,7 @@ void StageMenu::drawStageInfo(Graphics* g) {
     // Check if the stage in the cursor
     // position exists
     int index = stageGrid.getChoseStageIndex() -1;
-    if(index < 0 || index >= maps.size()) {
+    if(index < 0 || index >= mapNames.size()) {
         return;
     }
 
@@ -214,18 +216,17 @@ void StageMenu::init() {
     trans = evMan->getTransition();
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
     // Get samples
-    sReject = assets->getSample("reject");
+    sReject = assets->getSample(NAME_ID("reject"));
     // Get music
-    mMenu = assets->getMusic("menu");
+    mMenu = assets->getMusic(NAME_ID("menu"));
 
     // Create components
     stageGrid = Grid(assets, WIDTH, HEIGHT, 
         BUTTON_W, BUTTON_H, XOFF, YOFF);
 
     // Find existing maps & load them
-    const std::string BASE_PATH = "Assets/Tilemaps/New/";
     const int MAX = 100;
     maps = std::vector<Tilemap> ();
     mapNames = std::vector<std::string> ();
@@ -233,14 +234,21 @@ void StageMenu::init() {
     completion = std::vector<int> ();
     try {
 
+        Tilemap* packed;
         for(int i = 1; i <= MAX; ++ i) {
 
-            maps.push_back(Tilemap(BASE_PATH 
-                + intToString(i) + ".tmx"));
+            // Archived maps are named by their path
+            // in the tilemap directory
+            packed = assets->getTilemap("New/" + intToString(i));
+            if(packed != NULL)
+                maps.push_back(*packed);
+            else
+                maps.push_back(Tilemap::load(MAP_PATH 
+                    + intToString(i)));
 
             // Get info
-            mapNames.push_back(maps[i-1].getProp("name"));
-            mapDiff.push_back(strToInt(maps[i-1].getProp("difficulty")));
+            mapNames.push_back(maps[i-1].getName());
+            mapDiff.push_back(maps[i-1].getDifficulty());
 
             // Set default completion
             completion.push_back(0);
@@ -260,6 +268,9 @@ void StageMenu::init() {
 // Update scene
 void StageMenu::update(float tm) {
 
+    // Store the state for interpolation
+    stageGrid.storeState();
+
     if(trans->isActive()) return;
 
     GamePad* vpad = evMan->getController();
@@ -274,7 +285,7 @@ void StageMenu::update(float tm) {
     }
 
     // Check escape
-    if(vpad->getButton("cancel") 
+    if(vpad->getButton(NAME_ID("cancel")) 
         == State::Pressed) {
 
 
@@ -285,7 +296,7 @@ void StageMenu::update(float tm) {
     // Check debug button
     // TEMP
     if(endingState < 2 &&
-        vpad->getButton("debug") == State::Pressed) {
+        vpad->getButton(NAME_ID("debug")) == State::Pressed) {
 
         ++ endingState;
         fadeToTarget(cb_ToEnding);
@@ -381,3 +392,68 @@ void StageMenu::onChange(void* param) {
     }
     
 }
+
+
+// Called when a file has changed
+void StageMenu::onFileChange(std::string path) {
+
+    // A stage, as a TMX or a compiled file
+    if(path.compare(0, MAP_PATH.length(), MAP_PATH) != 0)
+        return;
+
+    std::string name = path.substr(MAP_PATH.length());
+    size_t dot = name.rfind('.');
+    if(dot == std::string::npos)
+        return;
+
+    std::string ext = name.substr(dot);
+    name = name.substr(0, dot);
+    if(ext != ".tmx" && ext != ".stage")
+        return;
+
+    // Only the stages loaded at the start, a new
+    // one would move the others in memory
+    int index = strToInt(name);
+    if(index <= 0 || index > maps.size())
+        return;
+
+    // Reload in place, so that the game scene
+    // keeps pointing to it
+    try {
+
+        maps[index-1] = Tilemap::load(MAP_PATH + name);
+    }
+    catch(std::runtime_error err) {
+
+        printf("Warning: could not reload %s: %s\n",
+            path.c_str(), err.what());
+        return;
+    }
+    mapNames[index-1] = maps[index-1].getName();
+    mapDiff[index-1] = maps[index-1].getDifficulty();
+
+    printf("Reloaded %s\n", path.c_str());
+}
+
+
+// Is the grid animating
+bool StageMenu::isAnimating() {
+
+    return stageGrid.isAnimating();
+}
+
+
+// Copy what is drawn
+Scene* StageMenu::copyState(Scene* dst) {
+
+    // The maps themselves are not drawn,
+    // so they are left out
+    StageMenu* s = dst == NULL ? new StageMenu() : (StageMenu*)dst;
+    s->bmpFont = bmpFont;
+    s->stageGrid = stageGrid;
+    s->mapNames = mapNames;
+    s->mapDiff = mapDiff;
+    s->completion = completion;
+
+    return s;
+}
@@ -94,6 +94,12 @@ public:
     // Called when the scene is changed
     // to this scene
     void onChange(void* param=NULL);
+    // Called when a file has changed
+    void onFileChange(std::string path);
+    // Is the grid animating
+    bool isAnimating();
+    // Copy what is drawn
+    Scene* copyState(Scene* dst);
 
     // Get name
     inline std::string getName() {
@@ -6,6 +6,7 @@
 #include "../Game/Stage.hpp"
 
 #include "../../Core/SceneManager.hpp"
+#include "../../Core/MathExt.hpp"
 #include "../../version.hpp"
 
 // Reference to self
@@ -38,15 +39,11 @@ static void cb_Reject() { tref->disableConfirmMenu(); }
 void Title::drawCog(Graphics* g, float x, float y,
     float scale, int dir) {
 
-    g->push();
-    g->translate(x, y);
-    g->rotate(cogAngle * dir);
-    g->scale(scale, scale);
-    g->useTransf();
-
-    g->drawBitmap(bmpCog, -128, -128);
-
-    g->pop();
+    g->drawInstance(bmpCog, 0, 0, 
+        bmpCog->getWidth(), bmpCog->getHeight(),
+        -128, -128, bmpCog->getWidth(), bmpCog->getHeight(),
+        x, y, lerp(oldCogAngle, cogAngle, g->getInterpolation()) * dir, 
+        scale);
 }
 
 
@@ -178,14 +175,14 @@ void Title::init() {
     trans = evMan->getTransition();
 
     // Get bitmaps
-    bmpFont = assets->getBitmap("font");
-    bmpLogo = assets->getBitmap("logo");
-    bmpCog = assets->getBitmap("cog");
+    bmpFont = assets->getBitmap(NAME_ID("font"));
+    bmpLogo = assets->getBitmap(NAME_ID("logo"));
+    bmpCog = assets->getBitmap(NAME_ID("cog"));
     // Get samples
-    sPause = assets->getSample("pause");
-    sReject = assets->getSample("reject");
+    sPause = assets->getSample(NAME_ID("pause"));
+    sReject = assets->getSample(NAME_ID("reject"));
     // Get music
-    mMenu = assets->getMusic("menu");
+    mMenu = assets->getMusic(NAME_ID("menu"));
 
     // Create menu
     std::vector<MenuButton> buttons;
@@ -221,6 +218,7 @@ void Title::init() {
     logoStopped = false;
     dataRemoved = false;
     cogAngle = 0.0f;
+    oldCogAngle = cogAngle;
 }
 
 
@@ -231,6 +229,9 @@ void Title::update(float tm) {
     const float ENTER_TIMER_SPEED = 0.05f;
     const float COG_SPEED = 0.05f;
 
+    // Store the state for interpolation
+    oldCogAngle = cogAngle;
+
     // Check settings
     if(settings.isActive()) {
 
@@ -255,7 +256,12 @@ void Title::update(float tm) {
 
     // Update cog angle
     cogAngle += COG_SPEED * tm;
-    cogAngle = fmodf(cogAngle, M_PI*2);
+    if(cogAngle >= M_PI*2) {
+
+        // Keep the previous angle on the same lap
+        cogAngle -= M_PI*2;
+        oldCogAngle -= M_PI*2;
+    }
 
     if(trans->isActive()) return;
 
@@ -289,8 +295,8 @@ void Title::update(float tm) {
         enterTimer = fmodf(enterTimer, M_PI*2);
 
         // Check enter
-        if(vpad->getButton("start") == State::Pressed ||
-            vpad->getButton("accept") == State::Pressed) {
+        if(vpad->getButton(NAME_ID("start")) == State::Pressed ||
+            vpad->getButton(NAME_ID("accept")) == State::Pressed) {
 
             // Play sound
             audio->playSample(sPause, 0.40f);
@@ -301,7 +307,7 @@ void Title::update(float tm) {
     }
 
     // Check escape
-    if(vpad->getButton("cancel") == State::Pressed) {
+    if(vpad->getButton(NAME_ID("cancel")) == State::Pressed) {
 
         audio->playSample(sReject, 0.40f);
         trans->activate(FadeIn, 2.0f, cb_Terminate);
@@ -52,6 +52,8 @@ private:
 
     // Cog angle
     float cogAngle;
+    // Cog angle before the latest step
+    float oldCogAngle;
 
     // Draw a cog
     void drawCog(Graphics* g, float x, float y, float scale, int dir);
@@ -99,6 +101,10 @@ public:
     void dispose();
     // On change
     void onChange(void* param=NULL);
+    // Copy the scene for drawing
+    inline Scene* copyState(Scene* dst) {
+        return copyScene(this, dst);
+    }
 
     // Get name
     inline std::string getName() {